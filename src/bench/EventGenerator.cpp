@@ -0,0 +1,213 @@
+#include "EventGenerator.h"
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QStringList>
+
+namespace GOL {
+
+static QString sectorName(int i) {
+  // Mix of numeric (San Siro style) and lettered (Olimpico style) blocks
+  return (i % 3 == 0) ? QString("%1B").arg(10 + i) : QString::number(100 + i);
+}
+
+static QString faceValue(QRandomGenerator &rng) {
+  int euros = 25 + rng.bounded(150);
+  int cents = rng.bounded(4) * 25;
+  return cents ? QString("FV%1p%2").arg(euros).arg(cents)
+               : QString("FV%1").arg(euros);
+}
+
+static void touch(const QString &path) {
+  QFile f(path);
+  f.open(QIODevice::WriteOnly);
+}
+
+EventGenerator::Stats EventGenerator::generateEvent(const QString &eventPath,
+                                                    const Options &opts) {
+  Stats stats;
+  QRandomGenerator rng(opts.seed);
+  QDir root(eventPath);
+  root.mkpath(".");
+
+  const int sectors = qMax(1, opts.sectors);
+  const int rows = qMax(1, opts.rowsPerSector);
+  const int stockTarget = opts.totalFiles * 70 / 100;
+  const int deliveredTarget = opts.totalFiles * 15 / 100;
+  const int orderTarget = opts.totalFiles - stockTarget - deliveredTarget;
+
+  // --- Stock: - Tickets -/<SEC>/SEC-ROW-SEAT-FVxx.pdf ---
+  QString ticketsPath = root.filePath("- Tickets -");
+  QDir().mkpath(ticketsPath);
+
+  int looseTarget = stockTarget / 50; // ~2% without sector folder
+  for (int i = 0; i < looseTarget; ++i) {
+    touch(QString("%1/EXTRA-%2-%3-%4.pdf")
+              .arg(ticketsPath)
+              .arg(1 + i / 20)
+              .arg(1 + i % 20)
+              .arg(faceValue(rng)));
+  }
+  stats.stockPdfs += looseTarget;
+
+  int perSector = (stockTarget - looseTarget) / sectors;
+  int remainder = (stockTarget - looseTarget) % sectors;
+  for (int s = 0; s < sectors; ++s) {
+    QString sec = sectorName(s);
+    QString secPath = ticketsPath + "/" + sec;
+    QDir().mkpath(secPath);
+
+    int count = perSector + (s < remainder ? 1 : 0);
+    int perRow = qMax(1, (count + rows - 1) / rows);
+    int written = 0;
+    for (int r = 1; written < count; ++r) {
+      QString fv = faceValue(rng); // One price per row, like real events
+      int seat = 1;
+      for (int k = 0; k < perRow && written < count; ++k) {
+        if (rng.bounded(10) == 0)
+          seat += 1 + rng.bounded(3); // Gap -> new consecutive group
+        QString seatStr = QString::number(seat);
+        if (rng.bounded(33) == 0)
+          seatStr += "A";
+        touch(QString("%1/%2-%3-%4-%5.pdf")
+                  .arg(secPath, sec)
+                  .arg(r)
+                  .arg(seatStr, fv));
+        ++seat;
+        ++written;
+      }
+    }
+    stats.stockPdfs += written;
+  }
+
+  // --- Delivered: caricati/<SEC>/SEC-ROW-SEAT.pdf ---
+  QString deliveredPath = root.filePath("caricati");
+  for (int i = 0; i < deliveredTarget; ++i) {
+    QString sec = sectorName(rng.bounded(sectors));
+    QString dir = deliveredPath + "/" + sec;
+    if (!QDir(dir).exists())
+      QDir().mkpath(dir);
+    touch(QString("%1/%2-%3-%4.pdf")
+              .arg(dir, sec)
+              .arg(1 + rng.bounded(rows))
+              .arg(1000 + i));
+  }
+  stats.deliveredPdfs = deliveredTarget;
+
+  // --- Pending orders: "<SEC> <Platform> <ID> xN [BOUGHT]" ---
+  int written = 0;
+  int orderNo = 0;
+  while (written < orderTarget) {
+    QString sec = sectorName(rng.bounded(sectors));
+    int qty = 1 + rng.bounded(4);
+    QString folder;
+    switch (orderNo % 3) {
+    case 0:
+      folder = QString("%1 Gogo %2 x%3")
+                   .arg(sec)
+                   .arg(600000000 + orderNo)
+                   .arg(qty);
+      break;
+    case 1:
+      folder =
+          QString("%1 Net %2 x%3").arg(sec).arg(1500000 + orderNo).arg(qty);
+      break;
+    default:
+      folder = QString("%1 Tixstock %2 x%3")
+                   .arg(sec)
+                   .arg(QString::number(0xBB000000u + orderNo, 16).toUpper())
+                   .arg(qty);
+      break;
+    }
+    if (rng.bounded(2) == 0)
+      folder += " BOUGHT";
+    QString orderPath = root.filePath(folder);
+    QDir().mkpath(orderPath);
+    for (int k = 0; k < qty; ++k)
+      touch(QString("%1/%2-%3-%4.pdf").arg(orderPath, sec).arg(1).arg(k + 1));
+    written += qty;
+    ++orderNo;
+  }
+  stats.orderFolders = orderNo;
+  stats.orderPdfs = written;
+
+  // Stock requests: empty, not bought order folders (deducted from stock)
+  int requests = qMax(1, orderNo / 5);
+  for (int i = 0; i < requests; ++i) {
+    root.mkpath(QString("%1 Gogo %2 x%3")
+                    .arg(sectorName(rng.bounded(sectors)))
+                    .arg(700000000 + i)
+                    .arg(1 + rng.bounded(4)));
+  }
+  stats.stockRequests = requests;
+
+  return stats;
+}
+
+QString EventGenerator::ftnHtml(int listings, quint32 seed) {
+  QRandomGenerator rng(seed);
+  QStringList parts;
+  parts << "<html><body><div class=\"stand_list\">";
+  for (int i = 0; i < listings; ++i) {
+    bool owned = rng.bounded(10) == 0;
+    parts << QString("<div class=\"listing\">"
+                     "<div class=\"stand_Sprice desktop%1\">"
+                     "<div class=\"category\"><span>Category %2</span></div>"
+                     "<div class=\"details\">"
+                     "<div class=\"block\">Block: %3</div>"
+                     "<span class=\"price\">€ %4.%5</span>"
+                     "<span class=\"qty\">Up To %6 Seats</span>"
+                     "</div></div></div>")
+                 .arg(owned ? " current_seller_ticket" : "")
+                 .arg(1 + rng.bounded(4))
+                 .arg(sectorName(rng.bounded(40)))
+                 .arg(60 + rng.bounded(300))
+                 .arg(rng.bounded(100), 2, 10, QChar('0'))
+                 .arg(1 + rng.bounded(6));
+  }
+  parts << "</div></body></html>";
+  return parts.join("\n");
+}
+
+QString EventGenerator::tixstockHtml(int listings, quint32 seed) {
+  QRandomGenerator rng(seed);
+  QStringList parts;
+  parts << "<html><body><table><thead><tr><th>Qty</th><th>Category</th>"
+           "<th>Section/Block</th><th>Row</th><th>Split</th>"
+           "<th>Ticket Price</th></tr></thead><tbody>";
+  for (int i = 0; i < listings; ++i) {
+    parts << QString("<tr><td><span>%1</span></td><td>Category %2</td>"
+                     "<td>%3</td><td>%4</td><td>Any</td>"
+                     "<td><b>€%5.00</b></td></tr>")
+                 .arg(1 + rng.bounded(6))
+                 .arg(1 + rng.bounded(4))
+                 .arg(sectorName(rng.bounded(40)))
+                 .arg(1 + rng.bounded(25))
+                 .arg(60 + rng.bounded(300));
+  }
+  parts << "</tbody></table></body></html>";
+  return parts.join("\n");
+}
+
+QString EventGenerator::viagogoHtml(int listings, quint32 seed) {
+  QRandomGenerator rng(seed);
+  QStringList parts;
+  parts << "<html><body><table><tr><th>#</th><th>Section</th><th>Area</th>"
+           "<th>Qty</th><th>Price</th></tr>";
+  for (int i = 0; i < listings; ++i) {
+    bool owned = rng.bounded(10) == 0;
+    parts << QString("<tr class=\"listing%1\"><td>%2</td><td>%3</td>"
+                     "<td>Area %4</td><td>%5 tickets</td>"
+                     "<td><input type=\"text\" value=\"€ %6.00\"></td></tr>")
+                 .arg(owned ? " owned" : "")
+                 .arg(i + 1)
+                 .arg(sectorName(rng.bounded(40)))
+                 .arg(1 + rng.bounded(4))
+                 .arg(1 + rng.bounded(6))
+                 .arg(60 + rng.bounded(300));
+  }
+  parts << "</table></body></html>";
+  return parts.join("\n");
+}
+
+} // namespace GOL
@@ -0,0 +1,42 @@
+#ifndef EVENTGENERATOR_H
+#define EVENTGENERATOR_H
+
+#include <QString>
+#include <QtGlobal>
+
+namespace GOL {
+
+// Builds synthetic event folders and market pages for gol_bench.
+// Layout mirrors a real event:
+//   <event>/- Tickets -/<SEC>/SEC-ROW-SEAT-FV12p50.pdf   (stock)
+//   <event>/- Tickets -/SEC-ROW-SEAT-FV..pdf             (loose stock)
+//   <event>/caricati/<SEC>/SEC-ROW-SEAT.pdf              (delivered)
+//   <event>/<SEC> Gogo 626946288 x2 [BOUGHT]/...pdf      (pending orders)
+class EventGenerator {
+public:
+  struct Options {
+    int totalFiles = 1000; // PDFs across stock, delivered and orders
+    int sectors = 40;
+    int rowsPerSector = 25;
+    quint32 seed = 20240901;
+  };
+
+  struct Stats {
+    int stockPdfs = 0;
+    int deliveredPdfs = 0;
+    int orderFolders = 0;
+    int orderPdfs = 0;
+    int stockRequests = 0; // Empty, not bought order folders
+  };
+
+  static Stats generateEvent(const QString &eventPath, const Options &opts);
+
+  // Market pages in the formats the CheckPrice parsers expect
+  static QString ftnHtml(int listings, quint32 seed);
+  static QString tixstockHtml(int listings, quint32 seed);
+  static QString viagogoHtml(int listings, quint32 seed);
+};
+
+} // namespace GOL
+
+#endif // EVENTGENERATOR_H
@@ -0,0 +1,184 @@
+// gol_bench - timing harness for the gol_core engines on synthetic events.
+//
+//   gol_bench [--sizes 100,1000,20000] [--iterations 3] [--dir PATH] [--keep]
+//
+// For every size an event tree is generated (see EventGenerator) and each
+// engine is timed; min / median / max wall time is printed per benchmark.
+
+#include "EventGenerator.h"
+#include "core/ListingEngine.h"
+#include "core/PriceEngine.h"
+#include "core/SectorResolver.h"
+#include "core/StockEngine.h"
+#include "core/StockManifest.h"
+#include "core/StockReportEngine.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+
+using namespace GOL;
+
+namespace {
+
+QTextStream &out() {
+  static QTextStream stream(stdout);
+  return stream;
+}
+
+struct Timing {
+  double minMs = 0;
+  double medianMs = 0;
+  double maxMs = 0;
+};
+
+Timing measure(int iterations, const std::function<void()> &fn) {
+  QList<double> samples;
+  for (int i = 0; i < iterations; ++i) {
+    QElapsedTimer timer;
+    timer.start();
+    fn();
+    samples.append(timer.nsecsElapsed() / 1e6);
+  }
+  std::sort(samples.begin(), samples.end());
+  return {samples.first(), samples[samples.size() / 2], samples.last()};
+}
+
+void report(const QString &name, int size, const Timing &t) {
+  out() << QString("%1 %2 %3 %4 %5\n")
+               .arg(name, -40)
+               .arg(size, 8)
+               .arg(t.minMs, 10, 'f', 2)
+               .arg(t.medianMs, 10, 'f', 2)
+               .arg(t.maxMs, 10, 'f', 2);
+  out().flush();
+}
+
+// Listing table that fits the generated stock: per sector, half of the
+// tickets split across the three platforms in pairs and fours.
+QList<ListingRow> listingsFor(const QString &stockText) {
+  QList<ListingRow> rows;
+  QRegularExpression secRe("Sector:\\s*(\\S+)\\s+Total:\\s*(\\d+)");
+  auto it = secRe.globalMatch(stockText);
+  while (it.hasNext()) {
+    auto m = it.next();
+    int budget = m.captured(2).toInt() / 2;
+    QStringList gogo, net, tix;
+    for (int i = 0; budget > 0; ++i) {
+      int q = qMin(budget, (i % 3 == 0) ? 4 : 2);
+      (i % 3 == 0 ? gogo : i % 3 == 1 ? net : tix) << QString::number(q);
+      budget -= q;
+    }
+    rows.append({m.captured(1), gogo.join(" + "), net.join(" + "),
+                 tix.join(" + ")});
+  }
+  return rows;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("gol_bench");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Benchmarks the GOLEVENTS tool engines.");
+  parser.addHelpOption();
+  QCommandLineOption sizesOpt("sizes", "Comma separated PDF counts per event.",
+                              "list", "100,1000,20000,100000");
+  QCommandLineOption iterOpt("iterations", "Runs per benchmark.", "N", "3");
+  QCommandLineOption dirOpt("dir", "Where to generate events (default: tmp).",
+                            "path");
+  QCommandLineOption keepOpt("keep", "Keep generated events on disk.");
+  parser.addOptions({sizesOpt, iterOpt, dirOpt, keepOpt});
+  parser.process(app);
+
+  QList<int> sizes;
+  for (const QString &s : parser.value(sizesOpt).split(',', Qt::SkipEmptyParts))
+    sizes.append(qBound(100, s.trimmed().toInt(), 500000));
+  int iterations = qMax(1, parser.value(iterOpt).toInt());
+
+  QTemporaryDir tmp;
+  tmp.setAutoRemove(!parser.isSet(keepOpt));
+  QString baseDir = parser.isSet(dirOpt) ? parser.value(dirOpt) : tmp.path();
+
+  SectorResolver resolver;
+  resolver.loadSectorDB();
+
+  out() << QString("%1 %2 %3 %4 %5\n")
+               .arg("benchmark", -40)
+               .arg("size", 8)
+               .arg("min ms", 10)
+               .arg("median ms", 10)
+               .arg("max ms", 10);
+
+  for (int size : sizes) {
+    QString eventPath = QDir(baseDir).filePath(
+        QString("Roma - Lazio %1").arg(size, 6, 10, QChar('0')));
+
+    QElapsedTimer genTimer;
+    genTimer.start();
+    EventGenerator::Options opts;
+    opts.totalFiles = size;
+    auto stats = EventGenerator::generateEvent(eventPath, opts);
+    out() << QString("-- generated %1 (%2 stock, %3 delivered, %4 orders) "
+                     "in %5 ms\n")
+                 .arg(QDir(eventPath).dirName())
+                 .arg(stats.stockPdfs)
+                 .arg(stats.deliveredPdfs)
+                 .arg(stats.orderFolders)
+                 .arg(genTimer.elapsed());
+
+    QString stockText;
+    report("CalcStock::generateReportContent", size,
+           measure(iterations, [&] {
+             stockText = StockEngine::generateReportContent(eventPath, false);
+           }));
+    report("CalcStock::generateReportContent serial", size,
+           measure(iterations, [&] {
+             StockEngine::generateReportContent(eventPath, false, false);
+           }));
+
+    StockManifest manifest(eventPath, false);
+    manifest.refresh(); // Cold scan fills the manifest
+    report("CalcStock manifest refresh (no change)", size,
+           measure(iterations, [&] { manifest.refresh(); }));
+
+    report("StockReport analyze", size, measure(iterations, [&] {
+             SectorResolver r = resolver;
+             StockReportEngine::analyze(eventPath, r);
+           }));
+
+    QList<ListingRow> rows = listingsFor(stockText);
+    report("CheckListing allocate (text)", size, measure(iterations, [&] {
+             ListingEngine::allocate(stockText, rows);
+           }));
+    StockModel::Event stock = StockEngine::buildModel(eventPath, false);
+    report("CheckListing allocate (model)", size, measure(iterations, [&] {
+             ListingEngine::allocate(stock, rows);
+           }));
+
+    // Market pages scale with the event: one listing per ~10 tickets
+    int listings = qMax(50, size / 10);
+    QString ftn = EventGenerator::ftnHtml(listings, size);
+    QString tix = EventGenerator::tixstockHtml(listings, size);
+    QString gogo = EventGenerator::viagogoHtml(listings, size);
+
+    report("CheckPrice parseFTNHtml", listings, measure(iterations, [&] {
+             PriceEngine::parseFTNHtml(ftn);
+           }));
+    report("CheckPrice parseTixstockHtml", listings, measure(iterations, [&] {
+             PriceEngine::parseTixstockHtml(tix);
+           }));
+    report("CheckPrice parseViagogoHtml", listings, measure(iterations, [&] {
+             PriceEngine::parseViagogoHtml(gogo);
+           }));
+  }
+
+  return 0;
+}
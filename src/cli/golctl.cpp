@@ -0,0 +1,773 @@
+// golctl - headless batch runner for the gol_core tool engines.
+//
+//   golctl stock    <event>...  [--odd-even] [--out DIR]
+//   golctl report   <event>...  [--sector-db FILE] [--write]
+//   golctl allocate --stock <event|report.txt> --listings <rows.csv>
+//                   [--minimize-splits] [--budget MS]
+//   golctl price    --platform ftn|tixstock|viagogo [--mode left|right]
+//                   [--stock <event>] [--csv FILE]
+//                   <page.html> [all_listings.html]
+//   golctl price    --folder <saved pages> [--mode left|right]
+//                   [--stock <event>]
+//   golctl verify   --folder <scan dir> <sales.csv|xlsx>...
+//   golctl history  <event.golph> [--sector NAME [--platform P]
+//                   [--kickoff ISO-DATETIME] [--days N]]
+//
+// Every command accepts --json and --jobs N. Multiple event folders are
+// processed concurrently on the global thread pool. With --stock, price
+// also appends the checked pages to that event's price history.
+
+#include "core/ListingEngine.h"
+#include "core/OrderEngine.h"
+#include "core/PriceEngine.h"
+#include "core/PriceHistory.h"
+#include "core/SectorResolver.h"
+#include "core/StockEngine.h"
+#include "core/StockReportEngine.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+using namespace GOL;
+
+namespace {
+
+enum ExitCode {
+  ExitOk = 0,         // Completed, nothing to report
+  ExitUsage = 1,      // Bad command line
+  ExitInputError = 2, // Missing folder / unreadable file
+  ExitWarnings = 3    // Completed, but the result needs attention
+};
+
+QTextStream &out() {
+  static QTextStream stream(stdout);
+  static bool init = false;
+  if (!init) {
+    stream.setEncoding(QStringConverter::Utf8);
+    init = true;
+  }
+  return stream;
+}
+
+QTextStream &err() {
+  static QTextStream stream(stderr);
+  static bool init = false;
+  if (!init) {
+    stream.setEncoding(QStringConverter::Utf8);
+    init = true;
+  }
+  return stream;
+}
+
+void printJson(const QJsonValue &value) {
+  QJsonDocument doc = value.isArray() ? QJsonDocument(value.toArray())
+                                      : QJsonDocument(value.toObject());
+  out() << doc.toJson(QJsonDocument::Indented);
+  out().flush();
+}
+
+QJsonObject toJson(const QMap<QString, int> &map) {
+  QJsonObject obj;
+  for (auto it = map.begin(); it != map.end(); ++it)
+    obj[it.key()] = it.value();
+  return obj;
+}
+
+bool readTextFile(const QString &path, QString &content) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    return false;
+  QTextStream in(&file);
+  in.setEncoding(QStringConverter::Utf8);
+  content = in.readAll();
+  return true;
+}
+
+bool writeTextFile(const QString &path, const QString &content) {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    return false;
+  QTextStream stream(&file);
+  stream.setEncoding(QStringConverter::Utf8);
+  stream << content;
+  return true;
+}
+
+// ---------------------------------------------------------
+// stock
+// ---------------------------------------------------------
+
+struct StockJob {
+  QString path;
+  QString report;
+  bool ok = false;
+};
+
+int runStock(const QStringList &events, bool oddEven, const QString &outDir,
+             bool json) {
+  QList<StockJob> jobs = QtConcurrent::blockingMapped<QList<StockJob>>(
+      events, [oddEven](const QString &path) {
+        StockJob job;
+        job.path = path;
+        job.report = StockEngine::generateReportContent(path, oddEven);
+        job.ok = !job.report.isEmpty() &&
+                 job.report != StockEngine::ERROR_NO_TICKETS_FOLDER;
+        return job;
+      });
+
+  int code = ExitOk;
+  QJsonArray results;
+  for (const StockJob &job : jobs) {
+    QString eventName = QFileInfo(job.path).fileName();
+    if (!job.ok) {
+      err() << "golctl: " << job.path << ": '- Tickets -' folder not found\n";
+      code = ExitInputError;
+    } else if (!outDir.isEmpty()) {
+      QString safeEventName = eventName;
+      safeEventName.remove(QRegularExpression(R"([\\/*?:"<>|])"));
+      QString file = QString("%1/Stock_%2.txt").arg(outDir, safeEventName);
+      if (!writeTextFile(file, job.report)) {
+        err() << "golctl: could not write " << file << "\n";
+        code = ExitInputError;
+      }
+    }
+
+    if (json) {
+      QJsonObject obj;
+      obj["event"] = eventName;
+      obj["path"] = job.path;
+      obj["ok"] = job.ok;
+      if (job.ok)
+        obj["report"] = job.report;
+      results.append(obj);
+    } else if (job.ok) {
+      out() << job.report << "\n\n";
+    }
+  }
+
+  if (json)
+    printJson(results);
+  return code;
+}
+
+// ---------------------------------------------------------
+// report
+// ---------------------------------------------------------
+
+struct ReportJob {
+  QString path;
+  StockReportEngine::Result result;
+  QString text;
+  bool ok = false;
+};
+
+int runReport(const QStringList &events, const QString &sectorDb, bool write,
+              bool json) {
+  SectorResolver base;
+  base.loadSectorDB(sectorDb);
+
+  QList<ReportJob> jobs = QtConcurrent::blockingMapped<QList<ReportJob>>(
+      events, [&base](const QString &path) {
+        ReportJob job;
+        job.path = path;
+        if (!QDir(path).exists())
+          return job;
+        SectorResolver resolver = base; // Context is per event
+        job.result = StockReportEngine::analyze(path, resolver);
+        job.text = StockReportEngine::renderText(job.result);
+        job.ok = true;
+        return job;
+      });
+
+  int code = ExitOk;
+  QJsonArray results;
+  for (const ReportJob &job : jobs) {
+    if (!job.ok) {
+      err() << "golctl: " << job.path << ": invalid folder\n";
+      code = ExitInputError;
+      continue;
+    }
+
+    bool negative = false;
+    for (int v : job.result.netStockMap)
+      negative = negative || v < 0;
+    if (negative && code == ExitOk)
+      code = ExitWarnings;
+
+    if (write &&
+        !writeTextFile(QDir(job.path).filePath("report.txt"), job.text)) {
+      err() << "golctl: could not write report.txt in " << job.path << "\n";
+      code = ExitInputError;
+    }
+
+    if (json) {
+      QJsonObject obj;
+      obj["event"] = job.result.eventTitle;
+      obj["path"] = job.path;
+      obj["context"] = job.result.context;
+      obj["stock"] = toJson(job.result.netStockMap);
+      obj["physicalStock"] = toJson(job.result.stockMap);
+      obj["stockRequests"] = toJson(job.result.stockRequests);
+      obj["pending"] = toJson(job.result.pendingMap);
+      obj["delivered"] = toJson(job.result.deliveredMap);
+      obj["platformTotals"] = toJson(job.result.platTotals);
+      obj["negativeStock"] = negative;
+      results.append(obj);
+    } else {
+      out() << job.text << "\n\n";
+    }
+  }
+
+  if (json)
+    printJson(results);
+  return code;
+}
+
+// ---------------------------------------------------------
+// allocate
+// ---------------------------------------------------------
+
+int runAllocate(const QString &stockArg, const QString &listingsPath,
+                const ListingEngine::AllocationOptions &options, bool json) {
+  // An event folder is allocated on the stock model, a saved report is
+  // parsed back from its text
+  bool fromFolder = QFileInfo(stockArg).isDir();
+  StockModel::Event stock;
+  QString stockText;
+  if (fromFolder) {
+    stock = StockEngine::buildModel(stockArg, false);
+    if (stock.error == StockEngine::ERROR_NO_TICKETS_FOLDER) {
+      err() << "golctl: " << stockArg << ": '- Tickets -' folder not found\n";
+      return ExitInputError;
+    }
+  } else if (!readTextFile(stockArg, stockText)) {
+    err() << "golctl: cannot read " << stockArg << "\n";
+    return ExitInputError;
+  }
+
+  // One table row per line: sector,gogo,net,tix ("2 + 4" allowed per cell)
+  QString listingsText;
+  if (!readTextFile(listingsPath, listingsText)) {
+    err() << "golctl: cannot read " << listingsPath << "\n";
+    return ExitInputError;
+  }
+
+  QList<ListingRow> rows;
+  const QStringList lines = listingsText.split('\n', Qt::SkipEmptyParts);
+  for (const QString &line : lines) {
+    QChar delim = line.contains('\t') ? '\t' : (line.contains(';') ? ';' : ',');
+    QStringList cells = OrderEngine::parseCsvLine(line, delim);
+    if (cells.value(0).compare("sector", Qt::CaseInsensitive) == 0)
+      continue; // Header
+    rows.append({cells.value(0), cells.value(1), cells.value(2),
+                 cells.value(3)});
+  }
+
+  ListingEngine::AllocationResult result =
+      fromFolder
+          ? ListingEngine::allocate(stock, rows, options)
+          : ListingEngine::allocate(stockText.trimmed(), rows, options);
+
+  if (json) {
+    QJsonObject obj;
+    obj["totalListed"] = result.grandTotal;
+    obj["splitListings"] = result.splitListings;
+    obj["timedOutSectors"] = result.timedOutSectors;
+    obj["danger"] = QJsonArray::fromStringList(result.danger);
+    obj["missing"] = QJsonArray::fromStringList(result.missingStock);
+    obj["result"] = result.text;
+    printJson(obj);
+  } else if (!result.danger.isEmpty()) {
+    out() << "STOP! INSUFFICIENT STOCK:\n" << result.danger.join('\n') << "\n";
+  } else {
+    out() << result.text << "\n";
+    if (!result.missingStock.isEmpty())
+      out() << "\nWARNING: MISSING ITEMS:\n"
+            << result.missingStock.join('\n') << "\n";
+  }
+
+  return (result.danger.isEmpty() && result.missingStock.isEmpty())
+             ? ExitOk
+             : ExitWarnings;
+}
+
+// ---------------------------------------------------------
+// price
+// ---------------------------------------------------------
+
+Platform parsePlatform(const QString &name) {
+  QString p = name.toLower();
+  if (p == "ftn" || p == "net")
+    return Platform::FTN;
+  if (p == "tixstock" || p == "tix")
+    return Platform::TIXSTOCK;
+  if (p == "viagogo" || p == "gogo")
+    return Platform::VIAGOGO;
+  return Platform::UNKNOWN;
+}
+
+// --stock: the face values that floor the suggested prices, in the
+// event's stadium context. eventName is empty without an event.
+bool loadEvent(const QString &stockPath, const QString &sectorDb,
+               PriceFloors &floors, QString &eventName) {
+  if (stockPath.isEmpty())
+    return true;
+  StockModel::Event stock = StockEngine::buildModel(stockPath, false);
+  if (stock.error == StockEngine::ERROR_NO_TICKETS_FOLDER) {
+    err() << "golctl: " << stockPath << ": '- Tickets -' folder not found\n";
+    return false;
+  }
+  SectorResolver resolver;
+  resolver.loadSectorDB(sectorDb);
+  resolver.setContext(SectorResolver::detectStadiumContext(stock.name));
+  floors = PriceEngine::faceValueFloors(stock, resolver);
+  eventName = stock.name;
+  return true;
+}
+
+// Appends one checked page to the event's history, stamped with the save
+// time of the page holding the market
+bool appendHistory(const QString &eventName, Platform platform,
+                   const QString &marketFile,
+                   const QList<PriceRecord> &records) {
+  PriceHistoryStore store(PriceHistoryStore::pathForEvent(eventName));
+  QString error;
+  qint64 savedAt = QFileInfo(marketFile).lastModified().toMSecsSinceEpoch();
+  if (store.append(savedAt, platform, records, &error))
+    return true;
+  err() << "golctl: price history not saved: " << error << "\n";
+  return false;
+}
+
+int runPrice(const QString &platformArg, const QString &modeArg,
+             const QStringList &files, const QString &stockPath,
+             const QString &sectorDb, const QString &csvPath, bool json) {
+  Platform platform = parsePlatform(platformArg);
+  if (platform == Platform::UNKNOWN) {
+    err() << "golctl: --platform must be ftn, tixstock or viagogo\n";
+    return ExitUsage;
+  }
+  int needed = (platform == Platform::TIXSTOCK) ? 2 : 1;
+  if (files.size() < needed) {
+    err() << "golctl: price needs " << needed << " HTML file(s)\n";
+    return ExitUsage;
+  }
+
+  CompareMode mode = (modeArg.compare("right", Qt::CaseInsensitive) == 0)
+                         ? CompareMode::RIGHT_FILTER
+                         : CompareMode::LEFT_FILTER;
+
+  QString html1, html2;
+  if (!readTextFile(files[0], html1) ||
+      (needed == 2 && !readTextFile(files[1], html2))) {
+    err() << "golctl: cannot read HTML input\n";
+    return ExitInputError;
+  }
+
+  PriceFloors floors;
+  QString eventName;
+  if (!loadEvent(stockPath, sectorDb, floors, eventName))
+    return ExitInputError;
+
+  QList<PriceRecord> records;
+  QList<PriceCheck> checks = PriceEngine::checkListings(
+      platform, mode, html1, html2, floors, &records);
+  if (!eventName.isEmpty() &&
+      !appendHistory(eventName, platform, files[needed - 1], records))
+    return ExitInputError;
+  if (!csvPath.isEmpty() &&
+      !writeTextFile(csvPath, PriceEngine::repricingCsv(platform, checks))) {
+    err() << "golctl: could not write " << csvPath << "\n";
+    return ExitInputError;
+  }
+
+  QString report = PriceEngine::formatReport(checks);
+  int notFirst = 0;
+  for (const PriceCheck &c : checks)
+    notFirst += c.position.rank > 1 ? 1 : 0;
+  int first = int(checks.size()) - notFirst;
+
+  if (json) {
+    QJsonObject obj;
+    obj["first"] = first;
+    obj["notFirst"] = notFirst;
+    obj["report"] = report;
+    printJson(obj);
+  } else {
+    out() << report << "\n";
+  }
+
+  if (checks.isEmpty())
+    return ExitInputError; // No owned listings parsed
+  return notFirst > 0 ? ExitWarnings : ExitOk;
+}
+
+// Every saved page of a folder, platform detected per page
+int runPriceBatch(const QString &folder, const QString &modeArg,
+                  const QString &stockPath, const QString &sectorDb,
+                  bool json) {
+  QList<PageCheck> pages = PriceEngine::batchPages(folder);
+  if (pages.isEmpty()) {
+    err() << "golctl: no HTML pages in " << folder << "\n";
+    return ExitInputError;
+  }
+
+  PriceFloors floors;
+  QString eventName;
+  if (!loadEvent(stockPath, sectorDb, floors, eventName))
+    return ExitInputError;
+
+  CompareMode mode = (modeArg.compare("right", Qt::CaseInsensitive) == 0)
+                         ? CompareMode::RIGHT_FILTER
+                         : CompareMode::LEFT_FILTER;
+  QFuture<PageCheck> future = PriceEngine::checkPages(pages, mode, floors);
+  future.waitForFinished();
+  pages = future.results();
+
+  int code = ExitOk;
+  for (const PageCheck &page : std::as_const(pages)) {
+    if (eventName.isEmpty() || !page.error.isEmpty())
+      continue;
+    QString marketFile =
+        page.marketPath.isEmpty() ? page.path : page.marketPath;
+    if (!appendHistory(eventName, page.platform, marketFile, page.records)) {
+      code = ExitInputError;
+      break;
+    }
+  }
+
+  QJsonArray results;
+  for (const PageCheck &page : pages) {
+    int notFirst = 0;
+    for (const PriceCheck &c : page.checks)
+      notFirst += c.position.rank > 1 ? 1 : 0;
+    if (!page.error.isEmpty() || page.checks.isEmpty())
+      code = ExitInputError;
+    else if (notFirst > 0 && code == ExitOk)
+      code = ExitWarnings;
+
+    if (json) {
+      QJsonObject obj;
+      obj["page"] = page.path;
+      obj["platform"] = PriceEngine::platformName(page.platform);
+      obj["error"] = page.error;
+      obj["listings"] = int(page.checks.size());
+      obj["notFirst"] = notFirst;
+      obj["report"] = PriceEngine::formatReport(page.checks);
+      results.append(obj);
+    }
+  }
+
+  if (json)
+    printJson(results);
+  else
+    out() << PriceEngine::batchReport(pages) << "\n";
+  return code;
+}
+
+// ---------------------------------------------------------
+// history
+// ---------------------------------------------------------
+
+int runHistory(const QString &path, const QString &sector,
+               const QString &platformArg, const QString &kickoffArg, int days,
+               bool json) {
+  if (!QFileInfo::exists(path)) {
+    err() << "golctl: no price history at " << path << "\n";
+    return ExitInputError;
+  }
+  PriceHistoryStore store(path);
+  QString error;
+
+  // No sector: what the file holds
+  if (sector.isEmpty()) {
+    int snapshots = store.snapshotCount(&error);
+    QStringList sectors = store.sectors(&error);
+    if (!error.isEmpty()) {
+      err() << "golctl: " << error << "\n";
+      return ExitInputError;
+    }
+    if (json) {
+      QJsonObject obj;
+      obj["snapshots"] = snapshots;
+      obj["sectors"] = QJsonArray::fromStringList(sectors);
+      printJson(obj);
+    } else {
+      out() << "SNAPSHOTS: " << snapshots << "\n";
+      for (const QString &s : sectors)
+        out() << "   - " << s << "\n";
+    }
+    return ExitOk;
+  }
+
+  Platform platform = Platform::UNKNOWN;
+  if (!platformArg.isEmpty()) {
+    platform = parsePlatform(platformArg);
+    if (platform == Platform::UNKNOWN) {
+      err() << "golctl: --platform must be ftn, tixstock or viagogo\n";
+      return ExitUsage;
+    }
+  }
+
+  QList<PriceHistoryStore::FloorPoint> points;
+  PriceHistoryStore::FloorTrend trend;
+  const bool withTrend = !kickoffArg.isEmpty();
+  if (withTrend) {
+    QDateTime kickoff = QDateTime::fromString(kickoffArg, Qt::ISODate);
+    if (!kickoff.isValid()) {
+      err() << "golctl: --kickoff must be an ISO date/time\n";
+      return ExitUsage;
+    }
+    trend = store.floorTrend(sector, kickoff, days, platform, &error);
+    points = trend.points;
+  } else {
+    points = store.floorHistory(sector, platform, &error);
+  }
+  if (!error.isEmpty()) {
+    err() << "golctl: " << error << "\n";
+    return ExitInputError;
+  }
+
+  if (json) {
+    QJsonArray arr;
+    for (const auto &p : points) {
+      QJsonObject obj;
+      obj["time"] = QDateTime::fromMSecsSinceEpoch(p.timestampMs)
+                        .toString(Qt::ISODate);
+      obj["platform"] = PriceEngine::platformName(p.platform);
+      obj["floor"] = p.floor;
+      obj["competitors"] = p.competitors;
+      arr.append(obj);
+    }
+    QJsonObject obj;
+    obj["sector"] = sector;
+    obj["points"] = arr;
+    if (withTrend) {
+      obj["firstFloor"] = trend.firstFloor;
+      obj["lastFloor"] = trend.lastFloor;
+      obj["eurosPerDay"] = trend.eurosPerDay;
+    }
+    printJson(obj);
+  } else {
+    out() << "FLOOR OF " << sector << "\n";
+    for (const auto &p : points)
+      out() << "   "
+            << QDateTime::fromMSecsSinceEpoch(p.timestampMs)
+                   .toString("yyyy-MM-dd HH:mm")
+            << "  " << PriceEngine::platformName(p.platform).leftJustified(9)
+            << QString::number(p.floor, 'f', 2) << " € (" << p.competitors
+            << " listings)\n";
+    if (withTrend && !points.isEmpty())
+      out() << "TREND: " << QString::number(trend.firstFloor, 'f', 2)
+            << " € -> " << QString::number(trend.lastFloor, 'f', 2) << " €, "
+            << QString::number(trend.eurosPerDay, 'f', 2) << " €/day\n";
+  }
+  return points.isEmpty() ? ExitWarnings : ExitOk;
+}
+
+// ---------------------------------------------------------
+// verify
+// ---------------------------------------------------------
+
+int runVerify(const QString &folder, const QStringList &salesFiles,
+              bool json) {
+  if (folder.isEmpty() || !QDir(folder).exists() || salesFiles.isEmpty()) {
+    err() << "golctl: verify needs --folder and at least one sales file\n";
+    return ExitUsage;
+  }
+
+  struct SalesFile {
+    QStringList ids;
+    QString error;
+  };
+  QList<SalesFile> perFile = QtConcurrent::blockingMapped<QList<SalesFile>>(
+      salesFiles, [](const QString &f) {
+        SalesFile file;
+        file.ids = OrderEngine::extractIds(f, &file.error);
+        return file;
+      });
+
+  QStringList allSalesIds;
+  for (const SalesFile &file : perFile) {
+    if (!file.error.isEmpty())
+      err() << "golctl: " << file.error << "\n";
+    allSalesIds.append(file.ids);
+  }
+  allSalesIds.removeDuplicates();
+
+  OrderEngine::VerifyResult result = OrderEngine::verify(allSalesIds, folder);
+
+  if (json) {
+    QJsonObject dupes;
+    for (auto it = result.dupes.begin(); it != result.dupes.end(); ++it)
+      dupes[it.key()] = QJsonArray::fromStringList(it.value());
+    QJsonObject obj;
+    obj["checked"] = allSalesIds.size();
+    obj["perfectMatches"] = result.perfectMatches();
+    obj["missing"] = QJsonArray::fromStringList(result.missing);
+    obj["duplicated"] = dupes;
+    printJson(obj);
+  } else {
+    out() << "PERFECT MATCHES : " << result.perfectMatches() << "\n";
+    out() << "MISSING IDs     : " << result.missing.size() << "\n";
+    out() << "DUPLICATED IDs  : " << result.dupes.size() << "\n";
+    for (const QString &miss : result.missing)
+      out() << "   - missing " << miss << "\n";
+    for (auto it = result.dupes.begin(); it != result.dupes.end(); ++it)
+      out() << "   - " << it.key() << " found in: [" << it.value().join(", ")
+            << "]\n";
+  }
+
+  return (result.missing.isEmpty() && result.dupes.isEmpty()) ? ExitOk
+                                                               : ExitWarnings;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("golctl");
+  QCoreApplication::setApplicationVersion(APP_VERSION);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Headless runner for the GOLEVENTS tool engines.\n"
+      "Commands: stock, report, allocate, price, verify, history");
+  parser.addHelpOption();
+  parser.addVersionOption();
+  parser.addPositionalArgument("command",
+                               "stock | report | allocate | price | verify | "
+                               "history");
+  parser.addPositionalArgument("inputs", "Event folders or input files.",
+                               "[inputs...]");
+
+  QCommandLineOption jsonOpt("json", "Print JSON instead of text.");
+  QCommandLineOption jobsOpt("jobs", "Worker threads (default: all cores).",
+                             "N");
+  QCommandLineOption oddEvenOpt("odd-even", "stock: odd-even seat numbering.");
+  QCommandLineOption outOpt("out", "stock: also save Stock_<event>.txt here.",
+                            "dir");
+  QCommandLineOption sectorDbOpt(
+      "sector-db", "report / price: sector_db.json path.", "file");
+  QCommandLineOption writeOpt("write", "report: write report.txt per event.");
+  QCommandLineOption stockOpt(
+      "stock",
+      "allocate: event folder or saved stock report; price: event folder "
+      "whose face values floor the suggested prices and whose price "
+      "history receives the pages.",
+      "path");
+  QCommandLineOption listingsOpt(
+      "listings", "allocate: CSV rows sector,gogo,net,tix.", "file");
+  QCommandLineOption minSplitsOpt(
+      "minimize-splits", "allocate: search for the fewest split listings.");
+  QCommandLineOption budgetOpt(
+      "budget", "allocate: solver time per sector (default: 50).", "ms");
+  QCommandLineOption platformOpt(
+      "platform", "price / history: ftn, tixstock or viagogo.", "name");
+  QCommandLineOption modeOpt("mode", "price: left (default) or right.",
+                             "filter", "left");
+  QCommandLineOption csvOpt("csv", "price: write the repricing CSV here.",
+                            "file");
+  QCommandLineOption folderOpt(
+      "folder", "verify: folder to scan; price: folder of saved pages.", "dir");
+  QCommandLineOption sectorOpt("sector", "history: floor of this sector.",
+                               "name");
+  QCommandLineOption kickoffOpt(
+      "kickoff", "history: kickoff time; prints the floor trend before it.",
+      "iso");
+  QCommandLineOption daysOpt("days", "history: trend window (default: 14).",
+                             "n", "14");
+
+  parser.addOptions({jsonOpt, jobsOpt, oddEvenOpt, outOpt, sectorDbOpt,
+                     writeOpt, stockOpt, listingsOpt, minSplitsOpt, budgetOpt,
+                     platformOpt, modeOpt, csvOpt, folderOpt, sectorOpt,
+                     kickoffOpt, daysOpt});
+  parser.process(app);
+
+  QStringList args = parser.positionalArguments();
+  if (args.isEmpty()) {
+    err() << parser.helpText();
+    return ExitUsage;
+  }
+
+  if (parser.isSet(jobsOpt)) {
+    bool ok = false;
+    int jobs = parser.value(jobsOpt).toInt(&ok);
+    if (!ok || jobs < 1) {
+      err() << "golctl: --jobs must be a positive number\n";
+      return ExitUsage;
+    }
+    QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+  }
+
+  const QString command = args.takeFirst().toLower();
+  const bool json = parser.isSet(jsonOpt);
+
+  if (command == "stock" || command == "report") {
+    if (args.isEmpty()) {
+      err() << "golctl: " << command << " needs at least one event folder\n";
+      return ExitUsage;
+    }
+    if (command == "stock")
+      return runStock(args, parser.isSet(oddEvenOpt), parser.value(outOpt),
+                      json);
+    return runReport(args, parser.value(sectorDbOpt), parser.isSet(writeOpt),
+                     json);
+  }
+  if (command == "allocate") {
+    if (!parser.isSet(stockOpt) || !parser.isSet(listingsOpt)) {
+      err() << "golctl: allocate needs --stock and --listings\n";
+      return ExitUsage;
+    }
+    ListingEngine::AllocationOptions options;
+    options.minimizeSplits = parser.isSet(minSplitsOpt);
+    if (parser.isSet(budgetOpt)) {
+      bool ok = false;
+      options.budgetMs = parser.value(budgetOpt).toInt(&ok);
+      if (!ok || options.budgetMs < 1) {
+        err() << "golctl: --budget must be a positive number\n";
+        return ExitUsage;
+      }
+    }
+    return runAllocate(parser.value(stockOpt), parser.value(listingsOpt),
+                       options, json);
+  }
+  if (command == "price" && parser.isSet(folderOpt))
+    return runPriceBatch(parser.value(folderOpt), parser.value(modeOpt),
+                         parser.value(stockOpt), parser.value(sectorDbOpt),
+                         json);
+  if (command == "price")
+    return runPrice(parser.value(platformOpt), parser.value(modeOpt), args,
+                    parser.value(stockOpt), parser.value(sectorDbOpt),
+                    parser.value(csvOpt), json);
+  if (command == "verify")
+    return runVerify(parser.value(folderOpt), args, json);
+  if (command == "history") {
+    if (args.size() != 1) {
+      err() << "golctl: history needs one .golph file\n";
+      return ExitUsage;
+    }
+    bool ok = false;
+    int days = parser.value(daysOpt).toInt(&ok);
+    if (!ok || days < 1) {
+      err() << "golctl: --days must be a positive number\n";
+      return ExitUsage;
+    }
+    return runHistory(args.first(), parser.value(sectorOpt),
+                      parser.value(platformOpt), parser.value(kickoffOpt), days,
+                      json);
+  }
+
+  err() << "golctl: unknown command '" << command << "'\n\n"
+        << parser.helpText();
+  return ExitUsage;
+}
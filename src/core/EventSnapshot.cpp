@@ -0,0 +1,164 @@
+#include "EventSnapshot.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <algorithm>
+
+namespace GOL {
+
+static bool lessIgnoringCase(const QString &a, const QString &b) {
+  return a.compare(b, Qt::CaseInsensitive) < 0;
+}
+
+EventSnapshot EventSnapshot::scan(const QString &rootPath) {
+  EventSnapshot snapshot;
+  snapshot.m_root = rootPath;
+  if (rootPath.isEmpty() || !QDir(rootPath).exists())
+    return snapshot;
+
+  snapshot.walk(QString());
+  snapshot.sortAndCount();
+  return snapshot;
+}
+
+bool EventSnapshot::rescan(const QStringList &folders) {
+  QDir root(m_root);
+  if (m_dirs.isEmpty())
+    return false;
+  if (!root.exists()) {
+    m_dirs.clear();
+    return true;
+  }
+
+  bool changed = false;
+  for (const QString &folder : folders) {
+    QString dir = root.relativeFilePath(QDir::cleanPath(folder));
+    if (dir == ".")
+      dir.clear();
+    // Outside the event, or below a folder already dropped or re-walked
+    if (dir.startsWith("..") || !m_dirs.contains(dir))
+      continue;
+    QDir qdir(root.filePath(dir));
+    if (!qdir.exists())
+      continue; // Its parent reported the removal too
+
+    Dir fresh;
+    for (const QFileInfo &info :
+         qdir.entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot)) {
+      if (info.isDir())
+        fresh.subdirs.append(info.fileName());
+      else if (info.fileName().endsWith(".pdf", Qt::CaseInsensitive))
+        fresh.pdfs.append(info.fileName());
+    }
+    std::sort(fresh.subdirs.begin(), fresh.subdirs.end(), lessIgnoringCase);
+    std::sort(fresh.pdfs.begin(), fresh.pdfs.end(), lessIgnoringCase);
+
+    Dir &old = m_dirs[dir];
+    if (fresh.subdirs == old.subdirs && fresh.pdfs == old.pdfs)
+      continue;
+    changed = true;
+
+    const QStringList oldSubdirs = old.subdirs;
+    old.subdirs = fresh.subdirs;
+    old.pdfs = fresh.pdfs;
+    for (const QString &sub : oldSubdirs) {
+      if (!fresh.subdirs.contains(sub))
+        for (const QString &gone : subtree(join(dir, sub)))
+          m_dirs.remove(gone);
+    }
+    for (const QString &sub : fresh.subdirs) {
+      if (!oldSubdirs.contains(sub))
+        walk(join(dir, sub));
+    }
+  }
+
+  if (changed)
+    sortAndCount();
+  return changed;
+}
+
+void EventSnapshot::walk(const QString &dir) {
+  QDir root(m_root);
+  m_dirs[dir]; // Listed even when empty
+
+  QDirIterator it(root.filePath(dir),
+                  QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot,
+                  QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    QFileInfo info = it.fileInfo();
+    QString rel = root.relativeFilePath(info.filePath());
+    qsizetype slash = rel.lastIndexOf('/');
+    QString parent = slash < 0 ? QString() : rel.left(slash);
+    QString name = info.fileName();
+
+    if (info.isDir()) {
+      m_dirs[rel];
+      m_dirs[parent].subdirs.append(name);
+    } else if (name.endsWith(".pdf", Qt::CaseInsensitive)) {
+      m_dirs[parent].pdfs.append(name);
+    }
+  }
+}
+
+void EventSnapshot::sortAndCount() {
+  // Subtree totals, deepest directories first
+  QStringList order = m_dirs.keys();
+  auto depth = [](const QString &d) {
+    return d.isEmpty() ? 0 : int(d.count('/')) + 1;
+  };
+  std::sort(order.begin(), order.end(),
+            [&depth](const QString &a, const QString &b) {
+              return depth(a) > depth(b);
+            });
+  for (auto d = m_dirs.begin(); d != m_dirs.end(); ++d) {
+    std::sort(d->subdirs.begin(), d->subdirs.end(), lessIgnoringCase);
+    std::sort(d->pdfs.begin(), d->pdfs.end(), lessIgnoringCase);
+    d->totalPdfs = int(d->pdfs.size());
+  }
+  for (const QString &d : order) {
+    if (d.isEmpty())
+      continue;
+    qsizetype slash = d.lastIndexOf('/');
+    m_dirs[slash < 0 ? QString() : d.left(slash)].totalPdfs +=
+        m_dirs.value(d).totalPdfs;
+  }
+}
+
+QStringList EventSnapshot::subdirs(const QString &dir) const {
+  auto it = m_dirs.constFind(dir);
+  return it == m_dirs.constEnd() ? QStringList() : it->subdirs;
+}
+
+QStringList EventSnapshot::pdfs(const QString &dir) const {
+  auto it = m_dirs.constFind(dir);
+  return it == m_dirs.constEnd() ? QStringList() : it->pdfs;
+}
+
+int EventSnapshot::pdfCount(const QString &dir) const {
+  auto it = m_dirs.constFind(dir);
+  return it == m_dirs.constEnd() ? 0 : it->totalPdfs;
+}
+
+QStringList EventSnapshot::subtree(const QString &dir) const {
+  QStringList result;
+  if (!m_dirs.contains(dir))
+    return result;
+  result.append(dir);
+  for (qsizetype i = 0; i < result.size(); ++i) {
+    const QString current = result[i];
+    for (const QString &sub : m_dirs.value(current).subdirs)
+      result.append(join(current, sub));
+  }
+  return result;
+}
+
+QString EventSnapshot::join(const QString &dir, const QString &name) {
+  return dir.isEmpty() ? name : dir + '/' + name;
+}
+
+QString EventSnapshot::nameOf(const QString &dir) {
+  return dir.mid(dir.lastIndexOf('/') + 1);
+}
+
+} // namespace GOL
@@ -0,0 +1,55 @@
+#ifndef EVENTSNAPSHOT_H
+#define EVENTSNAPSHOT_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+namespace GOL {
+
+// In-memory listing of an event folder taken in one QDirIterator pass:
+// every directory below the root, the PDF names directly inside it and the
+// PDF count of its whole subtree. On network drives each directory walk
+// costs seconds, so the analysis asks this instead of the file system.
+class EventSnapshot {
+public:
+  static EventSnapshot scan(const QString &rootPath);
+
+  // Re-reads only the given folders (absolute paths, as FolderWatcher
+  // reports them), walking just the subfolders that appeared in them.
+  // Returns false when none of their PDFs or subfolders changed, e.g. when
+  // only a report.txt was written. A vanished root leaves it invalid.
+  bool rescan(const QStringList &folders);
+
+  QString rootPath() const { return m_root; }
+  bool isValid() const { return !m_dirs.isEmpty(); } // Root existed
+
+  // Directories are relative to the root, '/'-separated; "" is the root.
+  // Names come sorted like QDir::entryList (by name, ignoring case).
+  QStringList subdirs(const QString &dir = QString()) const;
+  QStringList pdfs(const QString &dir = QString()) const;
+  int pdfCount(const QString &dir) const; // Whole subtree
+  // dir and every directory below it, parents first
+  QStringList subtree(const QString &dir) const;
+
+  static QString join(const QString &dir, const QString &name);
+  static QString nameOf(const QString &dir); // Last path component
+
+private:
+  struct Dir {
+    QStringList subdirs;
+    QStringList pdfs;
+    int totalPdfs = 0;
+  };
+
+  // Adds dir (relative to the root) and everything below it
+  void walk(const QString &dir);
+  void sortAndCount();
+
+  QString m_root;
+  QHash<QString, Dir> m_dirs;
+};
+
+} // namespace GOL
+
+#endif // EVENTSNAPSHOT_H
@@ -0,0 +1,81 @@
+#include "FolderWatcher.h"
+#include <QDir>
+
+namespace GOL {
+
+// inotify watches are a per-user resource; big events stay well below this
+static const int MAX_WATCHED_FOLDERS = 4096;
+
+FolderWatcher::FolderWatcher(QObject *parent) : QObject(parent) {
+  m_timer.setSingleShot(true);
+  m_timer.setInterval(400);
+  connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this,
+          &FolderWatcher::onDirectoryChanged);
+  connect(&m_timer, &QTimer::timeout, this, &FolderWatcher::flush);
+}
+
+void FolderWatcher::watch(const QString &root, int maxDepth) {
+  stop();
+  m_root = QDir::cleanPath(root);
+  m_maxDepth = maxDepth;
+  resync();
+}
+
+void FolderWatcher::stop() {
+  m_timer.stop();
+  m_pending.clear();
+  if (!m_watcher.directories().isEmpty())
+    m_watcher.removePaths(m_watcher.directories());
+  m_root.clear();
+}
+
+void FolderWatcher::onDirectoryChanged(const QString &path) {
+  m_pending.insert(path);
+  m_timer.start(); // Restart: wait until the burst is over
+}
+
+void FolderWatcher::flush() {
+  if (m_pending.isEmpty())
+    return;
+  QStringList folders(m_pending.begin(), m_pending.end());
+  folders.sort();
+  m_pending.clear();
+  resync(); // New subfolders must be watched before anyone re-reads them
+  emit foldersChanged(folders);
+}
+
+void FolderWatcher::resync() {
+  if (m_root.isEmpty() || !QDir(m_root).exists())
+    return;
+
+  // Breadth-first so the cap drops the deepest folders first
+  QStringList wanted;
+  QStringList level = {m_root};
+  for (int depth = 0; !level.isEmpty(); ++depth) {
+    wanted.append(level);
+    if (depth == m_maxDepth || wanted.size() >= MAX_WATCHED_FOLDERS)
+      break;
+    QStringList next;
+    for (const QString &dir : level) {
+      for (const QString &sub :
+           QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+        next.append(dir + "/" + sub);
+    }
+    level = next;
+  }
+  if (wanted.size() > MAX_WATCHED_FOLDERS)
+    wanted = wanted.mid(0, MAX_WATCHED_FOLDERS);
+
+  QSet<QString> want(wanted.begin(), wanted.end());
+  const QStringList current = m_watcher.directories();
+  QSet<QString> have(current.begin(), current.end());
+
+  QSet<QString> gone = have - want;
+  if (!gone.isEmpty())
+    m_watcher.removePaths(QStringList(gone.begin(), gone.end()));
+  QSet<QString> added = want - have;
+  if (!added.isEmpty())
+    m_watcher.addPaths(QStringList(added.begin(), added.end()));
+}
+
+} // namespace GOL
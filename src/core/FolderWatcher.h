@@ -0,0 +1,50 @@
+#ifndef FOLDERWATCHER_H
+#define FOLDERWATCHER_H
+
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+namespace GOL {
+
+// Watches an event tree for the "live" modes. Bursts of change
+// notifications (a staff member dragging 40 PDFs into caricati) are
+// collapsed into one foldersChanged() after a short quiet period, and
+// folders created in the meantime are picked up automatically.
+class FolderWatcher : public QObject {
+  Q_OBJECT
+
+public:
+  explicit FolderWatcher(QObject *parent = nullptr);
+
+  // Watch root and its subfolders down to maxDepth levels (-1: all)
+  void watch(const QString &root, int maxDepth = -1);
+  void stop();
+  bool isActive() const { return !m_root.isEmpty(); }
+
+  void setDebounce(int ms) { m_timer.setInterval(ms); }
+
+signals:
+  // Folders that reported a change since the last emission
+  void foldersChanged(const QStringList &folders);
+
+private slots:
+  void onDirectoryChanged(const QString &path);
+  void flush();
+
+private:
+  void resync();
+
+  QFileSystemWatcher m_watcher;
+  QTimer m_timer;
+  QString m_root;
+  int m_maxDepth = -1;
+  QSet<QString> m_pending;
+};
+
+} // namespace GOL
+
+#endif // FOLDERWATCHER_H
@@ -0,0 +1,166 @@
+#include "HtmlTokenizer.h"
+
+namespace GOL {
+
+static bool isNameChar(QChar c) {
+  return c.isLetterOrNumber() || c == '-' || c == '_' || c == ':';
+}
+
+bool HtmlTokenizer::Token::isStart(QLatin1String tag) const {
+  return type == TokenType::StartTag &&
+         name.compare(tag, Qt::CaseInsensitive) == 0;
+}
+
+bool HtmlTokenizer::Token::isEnd(QLatin1String tag) const {
+  return type == TokenType::EndTag &&
+         name.compare(tag, Qt::CaseInsensitive) == 0;
+}
+
+QStringView HtmlTokenizer::Token::attribute(QLatin1String attr) const {
+  if (type != TokenType::StartTag)
+    return QStringView();
+
+  const qsizetype n = raw.endsWith(u'>') ? raw.size() - 1 : raw.size();
+  qsizetype i = 1 + name.size(); // After "<name"
+  while (i < n) {
+    if (raw[i].isSpace() || raw[i] == u'/') {
+      ++i;
+      continue;
+    }
+
+    qsizetype nameStart = i;
+    while (i < n && !raw[i].isSpace() && raw[i] != u'=' && raw[i] != u'/')
+      ++i;
+    QStringView attrName = raw.sliced(nameStart, i - nameStart);
+    while (i < n && raw[i].isSpace())
+      ++i;
+
+    QStringView value = raw.sliced(i, 0); // Present but empty
+    if (i < n && raw[i] == u'=') {
+      ++i;
+      while (i < n && raw[i].isSpace())
+        ++i;
+      if (i < n && (raw[i] == u'"' || raw[i] == u'\'')) {
+        QChar quote = raw[i++];
+        qsizetype valueStart = i;
+        while (i < n && raw[i] != quote)
+          ++i;
+        value = raw.sliced(valueStart, i - valueStart);
+        ++i; // Closing quote
+      } else {
+        qsizetype valueStart = i;
+        while (i < n && !raw[i].isSpace())
+          ++i;
+        value = raw.sliced(valueStart, i - valueStart);
+      }
+    }
+
+    if (attrName.compare(attr, Qt::CaseInsensitive) == 0)
+      return value;
+  }
+  return QStringView();
+}
+
+bool HtmlTokenizer::tagStartsAt(qsizetype pos) const {
+  if (pos + 1 >= m_html.size() || m_html[pos] != u'<')
+    return false;
+  QChar c = m_html[pos + 1];
+  if (c.isLetter() || c == u'!' || c == u'?')
+    return true;
+  return c == u'/' && pos + 2 < m_html.size() && m_html[pos + 2].isLetter();
+}
+
+qsizetype HtmlTokenizer::skipTo(QLatin1String terminator,
+                                qsizetype from) const {
+  qsizetype at = m_html.indexOf(terminator, from);
+  return at < 0 ? m_html.size() : at + terminator.size();
+}
+
+HtmlTokenizer::Token HtmlTokenizer::next() {
+  Token token;
+  const qsizetype size = m_html.size();
+
+  while (m_pos < size) {
+    // <script>/<style> body: everything up to the matching end tag
+    if (!m_rawTextTag.isNull()) {
+      qsizetype end = m_pos;
+      while ((end = m_html.indexOf(QLatin1String("</"), end)) >= 0 &&
+             !m_html.sliced(end + 2).startsWith(m_rawTextTag,
+                                                Qt::CaseInsensitive))
+        end += 2;
+      if (end < 0)
+        end = size;
+      m_rawTextTag = QStringView();
+      if (end > m_pos) {
+        token.type = TokenType::Text;
+        token.raw = m_html.sliced(m_pos, end - m_pos);
+        m_pos = end;
+        return token;
+      }
+      continue;
+    }
+
+    if (!tagStartsAt(m_pos)) {
+      qsizetype end = m_html.indexOf(u'<', m_pos + 1);
+      while (end >= 0 && !tagStartsAt(end))
+        end = m_html.indexOf(u'<', end + 1);
+      if (end < 0)
+        end = size;
+      token.type = TokenType::Text;
+      token.raw = m_html.sliced(m_pos, end - m_pos);
+      m_pos = end;
+      return token;
+    }
+
+    QStringView rest = m_html.sliced(m_pos);
+    if (rest.startsWith(QLatin1String("<!--"))) {
+      m_pos = skipTo(QLatin1String("-->"), m_pos + 4);
+      continue;
+    }
+    if (rest[1] == u'!' || rest[1] == u'?') {
+      m_pos = skipTo(QLatin1String(">"), m_pos + 2);
+      continue;
+    }
+
+    const bool endTag = rest[1] == u'/';
+    qsizetype i = m_pos + (endTag ? 2 : 1);
+    qsizetype nameStart = i;
+    while (i < size && isNameChar(m_html[i]))
+      ++i;
+    token.name = m_html.sliced(nameStart, i - nameStart);
+
+    // Tag end; a '>' inside a quoted attribute value does not count
+    QChar quote;
+    QChar lastNonSpace;
+    for (; i < size; ++i) {
+      QChar c = m_html[i];
+      if (!quote.isNull()) {
+        if (c == quote)
+          quote = QChar();
+      } else if ((c == u'"' || c == u'\'') && lastNonSpace == u'=') {
+        quote = c;
+      } else if (c == u'>') {
+        break;
+      }
+      if (!c.isSpace())
+        lastNonSpace = c;
+    }
+    qsizetype tagEnd = i < size ? i + 1 : size;
+
+    token.type = endTag ? TokenType::EndTag : TokenType::StartTag;
+    token.raw = m_html.sliced(m_pos, tagEnd - m_pos);
+    token.selfClosing = !endTag && token.raw.size() >= 2 &&
+                        token.raw[token.raw.size() - 2] == u'/';
+    m_pos = tagEnd;
+
+    if (token.type == TokenType::StartTag && !token.selfClosing &&
+        (token.isStart(QLatin1String("script")) ||
+         token.isStart(QLatin1String("style"))))
+      m_rawTextTag = token.name;
+    return token;
+  }
+
+  return token; // End
+}
+
+} // namespace GOL
@@ -0,0 +1,45 @@
+#ifndef HTMLTOKENIZER_H
+#define HTMLTOKENIZER_H
+
+#include <QString>
+#include <QStringView>
+
+namespace GOL {
+
+// Forward-only, SAX-style lexer for saved market pages. Tokens are views
+// into the caller's buffer, which must outlive them. There is no tree and
+// no entity decoding; comments, doctypes and processing instructions are
+// skipped, and <script>/<style> bodies come back as a single text token.
+class HtmlTokenizer {
+public:
+  enum class TokenType { StartTag, EndTag, Text, End };
+
+  struct Token {
+    TokenType type = TokenType::End;
+    QStringView name; // Tag name as written (tags only)
+    QStringView raw;  // Whole tag ("<td class=x>") or the text span
+    bool selfClosing = false;
+
+    bool isStart(QLatin1String tag) const;
+    bool isEnd(QLatin1String tag) const;
+    // Attribute value without quotes; null view if the tag has none
+    QStringView attribute(QLatin1String attr) const;
+  };
+
+  explicit HtmlTokenizer(QStringView html) : m_html(html) {}
+
+  Token next();
+  bool atEnd() const { return m_pos >= m_html.size(); }
+
+private:
+  bool tagStartsAt(qsizetype pos) const;
+  qsizetype skipTo(QLatin1String terminator, qsizetype from) const;
+
+  QStringView m_html;
+  qsizetype m_pos = 0;
+  QStringView m_rawTextTag; // "script" / "style" while inside their body
+};
+
+} // namespace GOL
+
+#endif // HTMLTOKENIZER_H
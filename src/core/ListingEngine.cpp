@@ -0,0 +1,988 @@
+#include "ListingEngine.h"
+#include "StockEngine.h"
+#include "StockManifest.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace GOL {
+
+struct Demand {
+  QString platform;
+  int qty; // Still to place
+  QString sector;
+  int listed = 0; // As listed
+  int parts = 0;  // Rows it ended up in
+};
+
+struct RowData {
+  QString sector;
+  int total;
+  int remaining;
+  QStringList allocs;
+  QString prefix;
+  int line;
+};
+
+// Rows of one sector (local positions follow line order) indexed for the
+// allocation passes: an exact-capacity bucket map for pass 1 and a max
+// segment tree over remaining capacity for the first-fit and split passes.
+class SectorRows {
+public:
+  void add(int rowIndex, int remaining) {
+    m_rows.append(rowIndex);
+    m_remaining.push_back(remaining);
+  }
+
+  void build() {
+    for (int pos = 0; pos < int(m_remaining.size()); ++pos)
+      m_byRemaining[m_remaining[pos]].insert(pos);
+    m_leaves = 1;
+    while (m_leaves < int(m_remaining.size()))
+      m_leaves *= 2;
+    m_tree.assign(2 * m_leaves, INT_MIN);
+    for (int pos = 0; pos < int(m_remaining.size()); ++pos)
+      m_tree[m_leaves + pos] = m_remaining[pos];
+    for (int i = m_leaves - 1; i > 0; --i)
+      m_tree[i] = std::max(m_tree[2 * i], m_tree[2 * i + 1]);
+  }
+
+  int size() const { return int(m_rows.size()); }
+  int rowAt(int pos) const { return m_rows[pos]; }
+  int remaining(int pos) const { return m_remaining[pos]; }
+
+  // First row whose remaining capacity is exactly qty, -1 if none
+  int findExact(int qty) const {
+    auto it = m_byRemaining.find(qty);
+    return (it == m_byRemaining.end() || it->second.empty())
+               ? -1
+               : *it->second.begin();
+  }
+
+  // First row with at least qty left, -1 if none
+  int findFirstFit(int qty) const {
+    if (m_tree.empty() || m_tree[1] < qty)
+      return -1;
+    int i = 1;
+    while (i < m_leaves)
+      i = (m_tree[2 * i] >= qty) ? 2 * i : 2 * i + 1;
+    return i - m_leaves;
+  }
+
+  void setRemaining(int pos, int value) {
+    auto &bucket = m_byRemaining[m_remaining[pos]];
+    bucket.erase(pos);
+    m_byRemaining[value].insert(pos);
+    m_remaining[pos] = value;
+
+    int i = m_leaves + pos;
+    m_tree[i] = value;
+    for (i /= 2; i > 0; i /= 2)
+      m_tree[i] = std::max(m_tree[2 * i], m_tree[2 * i + 1]);
+  }
+
+private:
+  QList<int> m_rows; // Index into the RowData list
+  std::vector<int> m_remaining;
+  std::map<int, std::set<int>> m_byRemaining; // Capacity -> positions
+  std::vector<int> m_tree;
+  int m_leaves = 0;
+};
+
+// Branch-and-bound for one sector. Demands are placed largest first, each
+// whole into a row or, only when no row can hold it, poured over the fullest
+// rows. Cost is the number of extra pieces of split listings first, then
+// fragments (rows left partly used). Rows with the same remaining capacity
+// and used/unused state are interchangeable, so only one of them is tried.
+class SplitSolver {
+public:
+  using Parts = std::vector<std::pair<int, int>>; // (row, qty)
+
+  SplitSolver(const std::vector<int> &capacities,
+              const std::vector<int> &quantities, int budgetMs)
+      : m_caps(capacities), m_rem(capacities), m_qty(quantities),
+        m_cur(quantities.size()), m_budgetMs(budgetMs) {
+    for (int d = 0; d < int(m_qty.size()); ++d)
+      m_order.push_back(d);
+    std::stable_sort(m_order.begin(), m_order.end(),
+                     [this](int a, int b) { return m_qty[a] > m_qty[b]; });
+  }
+
+  int cost(int splits, int fragments) const {
+    return splits * (int(m_caps.size()) + 1) + fragments;
+  }
+
+  // Looks for a solution cheaper than bound; true if one was found
+  bool solve(int bound) {
+    m_bestCost = bound;
+    m_timer.start();
+    search(0, 0);
+    return !m_best.empty();
+  }
+
+  bool timedOut() const { return m_timedOut; }
+  const std::vector<Parts> &best() const { return m_best; }
+
+private:
+  void search(int k, int splits) {
+    if (m_timedOut)
+      return;
+    if ((++m_nodes & 1023) == 0 && m_timer.elapsed() > m_budgetMs) {
+      m_timedOut = true; // Keep the best found so far
+      return;
+    }
+    if (cost(splits, 0) >= m_bestCost)
+      return;
+
+    if (k == int(m_order.size())) {
+      int fragments = 0;
+      for (int r = 0; r < int(m_caps.size()); ++r)
+        fragments += (m_rem[r] > 0 && m_rem[r] < m_caps[r]) ? 1 : 0;
+      if (cost(splits, fragments) < m_bestCost) {
+        m_bestCost = cost(splits, fragments);
+        m_best = m_cur;
+      }
+      return;
+    }
+
+    const int d = m_order[k];
+    const int q = m_qty[d];
+
+    // Whole placements, tightest row first
+    std::vector<int> fits;
+    std::set<std::pair<int, bool>> seen;
+    for (int r = 0; r < int(m_rem.size()); ++r) {
+      if (m_rem[r] >= q && seen.insert({m_rem[r], m_rem[r] < m_caps[r]}).second)
+        fits.push_back(r);
+    }
+    std::sort(fits.begin(), fits.end(),
+              [this](int a, int b) { return m_rem[a] < m_rem[b]; });
+
+    for (int r : fits) {
+      m_rem[r] -= q;
+      m_cur[d] = {{r, q}};
+      search(k + 1, splits);
+      m_rem[r] += q;
+    }
+    if (!fits.empty())
+      return;
+
+    // No row holds it: split over the fullest rows (fewest pieces)
+    std::vector<int> rows;
+    for (int r = 0; r < int(m_rem.size()); ++r) {
+      if (m_rem[r] > 0)
+        rows.push_back(r);
+    }
+    std::stable_sort(rows.begin(), rows.end(),
+                     [this](int a, int b) { return m_rem[a] > m_rem[b]; });
+    Parts parts;
+    int left = q;
+    for (int r : rows) {
+      if (left == 0)
+        break;
+      int take = std::min(left, m_rem[r]);
+      parts.push_back({r, take});
+      left -= take;
+    }
+    if (left > 0)
+      return; // Cannot happen after the danger check
+
+    for (const auto &p : parts)
+      m_rem[p.first] -= p.second;
+    m_cur[d] = parts;
+    search(k + 1, splits + int(parts.size()) - 1);
+    for (const auto &p : parts)
+      m_rem[p.first] += p.second;
+  }
+
+  std::vector<int> m_caps;
+  std::vector<int> m_rem;
+  std::vector<int> m_qty;
+  std::vector<int> m_order; // Demand indices, largest first
+  std::vector<Parts> m_cur;
+  std::vector<Parts> m_best;
+  int m_bestCost = 0;
+  int m_budgetMs;
+  QElapsedTimer m_timer;
+  qint64 m_nodes = 0;
+  bool m_timedOut = false;
+};
+
+// Re-solves each sector that has a split listing with SplitSolver and keeps
+// the result only if it beats the greedy passes. Allocations are rewritten
+// in the original demand order so the row text stays stable. Returns false
+// if advance() asked to stop.
+static bool minimizeSplits(const std::function<bool()> &advance,
+                           QList<RowData> &rowMap, QList<Demand> &demands,
+                           const QList<SectorRows> &sectors,
+                           const QHash<QString, int> &sectorIds,
+                           const ListingEngine::AllocationOptions &options,
+                           ListingEngine::AllocationResult *result) {
+  QList<QList<int>> sectorDemands(sectors.size());
+  for (int i = 0; i < demands.size(); ++i) {
+    int id = sectorIds.value(demands[i].sector, -1);
+    if (id >= 0)
+      sectorDemands[id].append(i);
+  }
+
+  for (int id = 0; id < sectors.size(); ++id) {
+    if (!advance())
+      return false;
+    const SectorRows &sr = sectors[id];
+    const QList<int> &ids = sectorDemands[id];
+
+    int splits = 0;
+    for (int i : ids)
+      splits += qMax(0, demands[i].parts - 1);
+    if (splits == 0)
+      continue; // Greedy already has no split listing here
+
+    std::vector<int> caps;
+    int fragments = 0;
+    for (int pos = 0; pos < sr.size(); ++pos) {
+      const RowData &r = rowMap[sr.rowAt(pos)];
+      caps.push_back(r.total);
+      fragments += (r.remaining > 0 && r.remaining < r.total) ? 1 : 0;
+    }
+    std::vector<int> qtys;
+    for (int i : ids)
+      qtys.push_back(demands[i].listed);
+
+    SplitSolver solver(caps, qtys, options.budgetMs);
+    bool improved = solver.solve(solver.cost(splits, fragments));
+    if (solver.timedOut())
+      result->timedOutSectors++;
+    if (!improved)
+      continue;
+
+    for (int pos = 0; pos < sr.size(); ++pos) {
+      RowData &r = rowMap[sr.rowAt(pos)];
+      r.allocs.clear();
+      r.remaining = r.total;
+    }
+    for (int k = 0; k < ids.size(); ++k) {
+      Demand &d = demands[ids[k]];
+      SplitSolver::Parts parts = solver.best()[k];
+      std::sort(parts.begin(), parts.end());
+      for (const auto &p : parts) {
+        RowData &r = rowMap[sr.rowAt(p.first)];
+        r.allocs.append(QString("X%1 %2").arg(p.second).arg(d.platform));
+        r.remaining -= p.second;
+      }
+      d.parts = int(parts.size());
+    }
+  }
+  return true;
+}
+
+ListingEngine::ParsedListings
+ListingEngine::parseListings(const QList<ListingRow> &rows) {
+  ParsedListings parsed;
+  auto &listings = parsed.byPlatform; // Platform -> Sector -> List of Qties
+  int grandSum = 0;
+
+  QRegularExpression qtyRe("\\d+");
+  for (const auto &row : rows) {
+    QString sec = row.sector.trimmed().toUpper();
+    if (sec.isEmpty())
+      continue;
+
+    auto parseAndAdd = [&](const QString &plat, const QString &cell) {
+      QString val = cell.trimmed();
+      if (val.isEmpty())
+        return;
+      auto it = qtyRe.globalMatch(val);
+      while (it.hasNext()) {
+        int q = it.next().captured(0).toInt();
+        listings[plat][sec].append(q);
+        grandSum += q;
+      }
+    };
+
+    parseAndAdd("GOGO", row.gogo);
+    parseAndAdd("NET", row.net);
+    parseAndAdd("TIXSTOCK", row.tix);
+  }
+
+  parsed.grandTotal = grandSum;
+  return parsed;
+}
+
+ListingEngine::AllocationResult
+ListingEngine::allocate(const QString &stockText,
+                        const QList<ListingRow> &rows,
+                        const AllocationOptions &options) {
+  // Parse Stock Text back into row slots (hand-edited or pasted reports)
+  QRegularExpression rowRe("(.*Row:.*?Qty:\\s*(\\d+)\\s*)\\[(.*?)\\]",
+                           QRegularExpression::CaseInsensitiveOption);
+  QRegularExpression secRe("Sector:\\s*([A-Za-z0-9]+)",
+                           QRegularExpression::CaseInsensitiveOption);
+
+  QStringList lines = stockText.split('\n');
+  QList<StockModel::Slot> slots;
+  QString currSec;
+
+  for (int i = 0; i < lines.size(); ++i) {
+    auto mSec = secRe.match(lines[i]);
+    if (mSec.hasMatch())
+      currSec = mSec.captured(1).toUpper();
+
+    auto mRow = rowRe.match(lines[i]);
+    if (mRow.hasMatch() && !currSec.isEmpty())
+      slots.append({currSec, mRow.captured(2).toInt(), i, mRow.captured(1)});
+  }
+
+  return allocate(lines, slots, rows, options);
+}
+
+// Report lines of a stock model as CheckListing shows them (trimmed, so
+// trailing blank lines go)
+static QStringList stockLines(const StockModel::Event &stock,
+                              QList<StockModel::Slot> *slots) {
+  QStringList lines = StockModel::renderLines(stock, slots);
+  while (!lines.isEmpty() && lines.last().isEmpty())
+    lines.removeLast();
+  return lines;
+}
+
+ListingEngine::AllocationResult
+ListingEngine::allocate(const StockModel::Event &stock,
+                        const QList<ListingRow> &rows,
+                        const AllocationOptions &options) {
+  QList<StockModel::Slot> slots;
+  QStringList lines = stockLines(stock, &slots);
+  return allocate(lines, slots, rows, options);
+}
+
+ListingEngine::AllocationResult
+ListingEngine::allocate(const QStringList &lines,
+                        const QList<StockModel::Slot> &slots,
+                        const QList<ListingRow> &rows,
+                        const AllocationOptions &options) {
+  return allocate(lines, slots, parseListings(rows), options);
+}
+
+ListingEngine::AllocationResult
+ListingEngine::allocate(const QStringList &lines,
+                        const QList<StockModel::Slot> &slots,
+                        const ParsedListings &parsed,
+                        const AllocationOptions &options) {
+  AllocationResult result;
+  QStringList platforms = {"GOGO", "NET", "TIXSTOCK"};
+  const auto &listings = parsed.byPlatform;
+  result.grandTotal = parsed.grandTotal;
+
+  QList<RowData> rowMap; // In line order
+  QMap<QString, int> secCap;
+  for (const auto &slot : slots) {
+    secCap[slot.sector] += slot.qty;
+    rowMap.append(
+        {slot.sector, slot.qty, slot.qty, {}, slot.prefix, slot.line});
+  }
+
+  // Danger Check
+  QSet<QString> allSectors;
+  for (const auto &p : platforms)
+    for (const auto &s : listings.value(p).keys())
+      allSectors.insert(s);
+
+  for (const QString &s : allSectors) {
+    int totNeeded = 0;
+    for (const auto &p : platforms)
+      for (int q : listings.value(p).value(s))
+        totNeeded += q;
+    int avail = secCap.value(s, 0);
+    if (totNeeded > avail) {
+      result.danger.append(QString("Sector %1: %2 listed vs %3 available")
+                               .arg(s)
+                               .arg(totNeeded)
+                               .arg(avail));
+    }
+  }
+
+  if (!result.danger.isEmpty())
+    return result;
+
+  // Allocation Logic
+  QList<Demand> demands;
+  for (const auto &p : platforms) {
+    const auto bySector = listings.value(p);
+    for (auto it = bySector.begin(); it != bySector.end(); ++it) {
+      for (int q : it.value())
+        demands.append({p, q, it.key(), q});
+    }
+  }
+
+  // Rows bucketed by interned sector id, so a demand only ever looks at
+  // the rows of its own sector
+  QHash<QString, int> sectorIds;
+  QList<SectorRows> sectors;
+  for (int i = 0; i < rowMap.size(); ++i) {
+    auto id = sectorIds.constFind(rowMap[i].sector);
+    if (id == sectorIds.constEnd()) {
+      id = sectorIds.insert(rowMap[i].sector, int(sectors.size()));
+      sectors.append(SectorRows());
+    }
+    sectors[id.value()].add(i, rowMap[i].remaining);
+  }
+  for (SectorRows &sr : sectors)
+    sr.build();
+
+  // One progress step per pass, plus one per sector for the solver
+  const int steps = 3 + (options.minimizeSplits ? int(sectors.size()) : 0);
+  int step = 0;
+  auto advance = [&]() {
+    return !options.progress || options.progress(step++, steps);
+  };
+
+  auto take = [&](SectorRows &sr, int pos, int qty, Demand &d) {
+    RowData &r = rowMap[sr.rowAt(pos)];
+    r.allocs.append(QString("X%1 %2").arg(qty).arg(d.platform));
+    r.remaining -= qty;
+    sr.setRemaining(pos, r.remaining);
+    d.parts++;
+  };
+
+  // Pass 1: Exact Match
+  if (!advance()) {
+    result.cancelled = true;
+    return result;
+  }
+  for (auto &d : demands) {
+    int id = sectorIds.value(d.sector, -1);
+    if (id < 0)
+      continue;
+    int pos = sectors[id].findExact(d.qty);
+    if (pos >= 0) {
+      take(sectors[id], pos, d.qty, d);
+      d.qty = 0;
+    }
+  }
+
+  // Pass 2: Best Fit (Fits in one row)
+  if (!advance()) {
+    result.cancelled = true;
+    return result;
+  }
+  for (auto &d : demands) {
+    int id = sectorIds.value(d.sector, -1);
+    if (d.qty <= 0 || id < 0)
+      continue;
+    int pos = sectors[id].findFirstFit(d.qty);
+    if (pos >= 0) {
+      take(sectors[id], pos, d.qty, d);
+      d.qty = 0;
+    }
+  }
+
+  // Pass 3: Fractional (Split)
+  if (!advance()) {
+    result.cancelled = true;
+    return result;
+  }
+  for (auto &d : demands) {
+    int id = sectorIds.value(d.sector, -1);
+    if (d.qty <= 0 || id < 0)
+      continue;
+    int pos;
+    while (d.qty > 0 && (pos = sectors[id].findFirstFit(1)) >= 0) {
+      int part = qMin(d.qty, sectors[id].remaining(pos));
+      take(sectors[id], pos, part, d);
+      d.qty -= part;
+    }
+  }
+
+  if (options.minimizeSplits &&
+      !minimizeSplits(advance, rowMap, demands, sectors, sectorIds, options,
+                      &result)) {
+    result.cancelled = true;
+    return result;
+  }
+  if (options.progress)
+    options.progress(steps, steps);
+
+  for (const Demand &d : demands)
+    result.splitListings += d.parts > 1 ? 1 : 0;
+
+  // Final Assembly
+  QStringList resultLines = lines;
+
+  for (RowData &r : rowMap) {
+    if (!r.allocs.isEmpty()) {
+      QString allocStr = r.allocs.join(" / ");
+      QString stillStr = "";
+
+      if (r.remaining > 0) {
+        stillStr = QString(" STILL X%1").arg(r.remaining);
+        result.missingStock.append(
+            QString("Sector %1: Missing X%2").arg(r.sector).arg(r.remaining));
+      }
+
+      resultLines[r.line] =
+          QString("%1[%2]%3").arg(r.prefix, allocStr, stillStr);
+    } else if (r.total > 0) {
+      // No allocations but we have this row mapped? Means we have stock
+      // but 0 allocated.
+      result.missingStock.append(QString("Sector %1: 100% Missing (X%2)")
+                                     .arg(r.sector)
+                                     .arg(r.total));
+    }
+  }
+
+  result.text = resultLines.join('\n');
+  return result;
+}
+
+// Runs allocate() inside a QPromise, wiring its progress hook to the future
+template <typename Stock>
+static QFuture<ListingEngine::AllocationResult>
+runAllocation(const Stock &stock, const QList<ListingRow> &rows,
+              const ListingEngine::AllocationOptions &options) {
+  return QtConcurrent::run(
+      [stock, rows,
+       options](QPromise<ListingEngine::AllocationResult> &promise) {
+        ListingEngine::AllocationOptions opts = options;
+        opts.progress = [&promise, &options](int done, int total) {
+          promise.setProgressRange(0, total);
+          promise.setProgressValue(done);
+          if (options.progress && !options.progress(done, total))
+            return false;
+          return !promise.isCanceled();
+        };
+        ListingEngine::AllocationResult result =
+            ListingEngine::allocate(stock, rows, opts);
+        if (!result.cancelled)
+          promise.addResult(result);
+      });
+}
+
+QFuture<ListingEngine::AllocationResult>
+ListingEngine::allocateAsync(const StockModel::Event &stock,
+                             const QList<ListingRow> &rows,
+                             const AllocationOptions &options) {
+  return runAllocation(stock, rows, options);
+}
+
+QFuture<ListingEngine::AllocationResult>
+ListingEngine::allocateAsync(const QString &stockText,
+                             const QList<ListingRow> &rows,
+                             const AllocationOptions &options) {
+  return runAllocation(stockText, rows, options);
+}
+
+QString ListingEngine::formatResult(const AllocationResult &result) {
+  if (!result.danger.isEmpty())
+    return "⚠️ STOP! INSUFFICIENT STOCK - PLEASE FIX:\n\n" +
+           result.danger.join('\n');
+
+  QString text = result.text;
+  if (!result.missingStock.isEmpty())
+    text += "\n\n⚠️ WARNING: MISSING ITEMS - YOU HAVE NOT LISTED "
+            "EVERYTHING:\n" +
+            result.missingStock.join('\n');
+  return text;
+}
+
+QFuture<ListingEngine::EventAllocation>
+ListingEngine::allocateEvents(const QStringList &eventPaths,
+                              const QList<ListingRow> &rows,
+                              const AllocationOptions &options) {
+  ParsedListings listings = parseListings(rows);
+  AllocationOptions opts = options;
+  opts.progress = nullptr; // Would be called from every worker at once
+
+  return QtConcurrent::mapped(
+      eventPaths, [listings, opts](const QString &path) {
+        EventAllocation event;
+        event.path = path;
+        event.name = QFileInfo(path).fileName();
+
+        StockModel::Event stock = StockManifest::generateModel(path, false);
+        if (!stock.error.isEmpty()) {
+          event.error = stock.error;
+          return event;
+        }
+
+        QList<StockModel::Slot> slots;
+        QStringList lines = stockLines(stock, &slots);
+        event.result = allocate(lines, slots, listings, opts);
+        return event;
+      });
+}
+
+QString ListingEngine::batchSummary(const QList<EventAllocation> &events) {
+  QStringList lines;
+  lines << QString("📚 BATCH: %1 events").arg(events.size());
+  lines << "========================================";
+
+  int ok = 0;
+  for (const EventAllocation &e : events) {
+    const AllocationResult &r = e.result;
+    if (e.error == StockEngine::ERROR_NO_TICKETS_FOLDER) {
+      lines << QString("❌ %1: '- Tickets -' folder not found").arg(e.name);
+    } else if (!e.error.isEmpty()) {
+      lines << QString("❌ %1: %2").arg(e.name, e.error);
+    } else if (!r.danger.isEmpty()) {
+      lines << QString("⚠️ %1: STOP! INSUFFICIENT STOCK").arg(e.name);
+      for (const QString &d : r.danger)
+        lines << "    " + d;
+    } else if (!r.missingStock.isEmpty()) {
+      lines << QString("⚠️ %1: %2 listed, %3 rows not fully listed")
+                   .arg(e.name)
+                   .arg(r.grandTotal)
+                   .arg(r.missingStock.size());
+      for (const QString &m : r.missingStock)
+        lines << "    " + m;
+    } else {
+      lines << QString("✅ %1: %2 listed").arg(e.name).arg(r.grandTotal);
+      ok++;
+    }
+  }
+
+  lines << "";
+  lines << QString("%1 of %2 events fully allocated")
+               .arg(ok)
+               .arg(events.size());
+  return lines.join('\n');
+}
+
+QStringList ListingEngine::sectorsFromReport(const QString &report) {
+  QStringList sectors;
+  QRegularExpression secRe("Sector:\\s*([^\\s]+)",
+                           QRegularExpression::CaseInsensitiveOption);
+
+  QStringList lines = report.split('\n');
+  for (const QString &line : lines) {
+    if (line.contains("Sector:", Qt::CaseInsensitive)) {
+      auto match = secRe.match(line);
+      if (match.hasMatch()) {
+        sectors.append(match.captured(1).trimmed());
+      }
+    }
+  }
+
+  // Remove duplicate sectors
+  sectors.removeDuplicates();
+  return sectors;
+}
+
+// ---------------------------------------------------------
+// IMPORTERS
+// ---------------------------------------------------------
+
+// Horspool search for a fixed needle inside [from, to) of a byte buffer
+class ByteFinder {
+public:
+  explicit ByteFinder(const char *needle)
+      : m_size(qsizetype(qstrlen(needle))),
+        m_searcher(needle, needle + m_size) {}
+
+  qsizetype size() const { return m_size; }
+
+  // Start of the first match beginning before `to` (-1: end), or -1
+  qsizetype find(QByteArrayView hay, qsizetype from,
+                 qsizetype to = -1) const {
+    qsizetype end = to < 0 ? hay.size() : qMin(hay.size(), to + m_size - 1);
+    if (from < 0 || end - from < m_size)
+      return -1;
+    const char *first = hay.data() + from;
+    const char *last = hay.data() + end;
+    const char *it = std::search(first, last, m_searcher);
+    return it == last ? -1 : it - hay.data();
+  }
+
+private:
+  qsizetype m_size;
+  std::boyer_moore_horspool_searcher<const char *> m_searcher;
+};
+
+static qsizetype indexOfByte(QByteArrayView hay, char c, qsizetype from) {
+  auto it = std::find(hay.begin() + from, hay.end(), c);
+  return it == hay.end() ? -1 : it - hay.begin();
+}
+
+// Look-ahead from an anchor to the cell it belongs to (same row)
+static constexpr qsizetype IMPORT_WINDOW = 2000;
+
+static void addImported(QMap<QString, QString> &data, const QString &sector,
+                        const QString &qty) {
+  if (data.contains(sector))
+    data[sector] += " + " + qty;
+  else
+    data[sector] = qty;
+}
+
+// <tr ... data-quantity="8"> ... <div class="t xs absl t0 w100
+// ellip">157</div> ... data-quantity is the row anchor, the sector is the
+// first ellip div after it.
+static QMap<QString, QString> scanGogo(QByteArrayView html, int *foundRows) {
+  static const ByteFinder anchorFinder("data-quantity=\"");
+  static const ByteFinder sectorFinder("class=\"t xs absl t0 w100 ellip\">");
+
+  QMap<QString, QString> importedData;
+  int found = 0;
+
+  qsizetype pos = 0;
+  while ((pos = anchorFinder.find(html, pos)) != -1) {
+    qsizetype digits = pos + anchorFinder.size();
+    qsizetype end = digits;
+    while (end < html.size() && html[end] >= '0' && html[end] <= '9')
+      ++end;
+    if (end == digits || end >= html.size() || html[end] != '"') {
+      pos += 1; // Not a numeric quantity
+      continue;
+    }
+    QString qtyStr = QString::fromLatin1(html.sliced(digits, end - digits));
+    qsizetype searchStart = end + 1;
+    pos = searchStart;
+
+    // Sanity check: Sector must be reasonably close (within the window)
+    qsizetype sec = searchStart;
+    while ((sec = sectorFinder.find(html, sec,
+                                    searchStart + IMPORT_WINDOW)) != -1) {
+      qsizetype textStart = sec + sectorFinder.size();
+      qsizetype textEnd = textStart;
+      while (textEnd < html.size() && html[textEnd] != '<')
+        ++textEnd;
+      if (textEnd > textStart &&
+          html.sliced(textEnd).startsWith(QByteArrayView("</div>"))) {
+        QString sector =
+            QString::fromUtf8(html.sliced(textStart, textEnd - textStart))
+                .trimmed();
+        // Clean up sector text if needed (sometimes invisible chars)
+        sector.remove('\n').remove('\r').remove('\t');
+
+        if (!sector.isEmpty()) {
+          addImported(importedData, sector, qtyStr);
+          found++;
+        }
+        break;
+      }
+      sec += 1;
+    }
+  }
+
+  if (foundRows)
+    *foundRows = found;
+  return importedData;
+}
+
+// class="quantity" ... class="quantity_value">4< ... then the
+// class="edit_ticket" action of the same row carries data-block="<sector>"
+static QMap<QString, QString> scanNet(QByteArrayView html) {
+  static const ByteFinder quantityFinder("class=\"quantity\"");
+  static const ByteFinder valueFinder("class=\"quantity_value\">");
+  static const ByteFinder editFinder("class=\"edit_ticket");
+  static const ByteFinder blockFinder("data-block=\"");
+
+  QMap<QString, QString> importedData;
+  qsizetype pos = 0;
+
+  while ((pos = quantityFinder.find(html, pos)) != -1) {
+    qsizetype qtyStart = valueFinder.find(html, pos);
+    if (qtyStart == -1)
+      break; // No quantity value further on either
+    qtyStart += valueFinder.size();
+    qsizetype qtyEnd = indexOfByte(html, '<', qtyStart);
+    if (qtyEnd == -1)
+      break;
+    QString qty =
+        QString::fromUtf8(html.sliced(qtyStart, qtyEnd - qtyStart)).trimmed();
+
+    // Safety: the edit action must be within the window to be the same row
+    qsizetype editStart =
+        editFinder.find(html, qtyEnd, qtyEnd + IMPORT_WINDOW);
+    if (editStart != -1) {
+      qsizetype blockRef = blockFinder.find(html, editStart);
+      if (blockRef != -1) {
+        blockRef += blockFinder.size();
+        qsizetype blockEnd = indexOfByte(html, '"', blockRef);
+        if (blockEnd != -1) {
+          QString sector =
+              QString::fromUtf8(html.sliced(blockRef, blockEnd - blockRef))
+                  .trimmed();
+          if (!sector.isEmpty() && !qty.isEmpty())
+            addImported(importedData, sector, qty);
+        }
+      }
+    }
+    pos = qtyEnd;
+  }
+
+  return importedData;
+}
+
+// Maps the file (falling back to a plain read) and scans its bytes
+static bool scanFile(const QString &path, QString *error,
+                     const std::function<void(QByteArrayView)> &scan) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    if (error)
+      *error = file.errorString();
+    return false;
+  }
+  if (file.size() == 0) {
+    scan(QByteArrayView());
+    return true;
+  }
+  if (uchar *map = file.map(0, file.size())) {
+    scan(QByteArrayView(reinterpret_cast<const char *>(map), file.size()));
+    file.unmap(map);
+    return true;
+  }
+  QByteArray data = file.readAll();
+  scan(data);
+  return true;
+}
+
+QMap<QString, QString> ListingEngine::parseGogoHtml(const QString &htmlContent,
+                                                    int *foundRows) {
+  return scanGogo(htmlContent.toUtf8(), foundRows);
+}
+
+QMap<QString, QString> ListingEngine::parseNetHtml(const QString &htmlContent) {
+  return scanNet(htmlContent.toUtf8());
+}
+
+QMap<QString, QString> ListingEngine::parseGogoFile(const QString &path,
+                                                    int *foundRows,
+                                                    QString *error) {
+  QMap<QString, QString> data;
+  scanFile(path, error,
+           [&](QByteArrayView html) { data = scanGogo(html, foundRows); });
+  return data;
+}
+
+QMap<QString, QString> ListingEngine::parseNetFile(const QString &path,
+                                                   QString *error) {
+  QMap<QString, QString> data;
+  scanFile(path, error, [&](QByteArrayView html) { data = scanNet(html); });
+  return data;
+}
+
+QString ListingEngine::sectorKey(const QString &sector) {
+  return sector.simplified().toCaseFolded();
+}
+
+QHash<QString, QString>
+ListingEngine::sectorAliases(const SectorResolver &resolver,
+                             const QString &context) {
+  QHash<QString, QString> aliases;
+  const auto &db = resolver.sectorDB();
+  auto ctxIt = db.constFind(context.toLower());
+  if (context.isEmpty() || ctxIt == db.constEnd())
+    return aliases;
+
+  for (auto it = ctxIt->constBegin(); it != ctxIt->constEnd(); ++it) {
+    QString sector = sectorKey(it.key());
+    for (const QString &block : it.value())
+      aliases.insert(sectorKey(block), sector);
+  }
+  return aliases;
+}
+
+ListingEngine::ImportResult
+ListingEngine::applyImports(QList<ListingRow> &rows, const Imports &imports,
+                            const QHash<QString, QString> &aliases) {
+  ImportResult result;
+
+  QHash<QString, QList<int>> rowsByKey;
+  for (int i = 0; i < rows.size(); ++i) {
+    QString key = sectorKey(rows[i].sector);
+    if (!key.isEmpty())
+      rowsByKey[key].append(i);
+  }
+
+  QSet<int> updated;
+  auto route = [&](const QMap<QString, QString> &imported,
+                   QString ListingRow::*cell) {
+    QMap<int, QStringList> values; // Row -> quantities, in import order
+    for (auto it = imported.constBegin(); it != imported.constEnd(); ++it) {
+      QString key = sectorKey(it.key());
+      auto hit = rowsByKey.constFind(key);
+      if (hit == rowsByKey.constEnd()) {
+        auto alias = aliases.constFind(key);
+        if (alias != aliases.constEnd())
+          hit = rowsByKey.constFind(alias.value());
+      }
+      if (hit == rowsByKey.constEnd()) {
+        result.unmatchedImported.append(it.key());
+        continue;
+      }
+      for (int r : hit.value())
+        values[r].append(it.value());
+    }
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+      rows[it.key()].*cell = it.value().join(" + ");
+      updated.insert(it.key());
+    }
+  };
+
+  route(imports.gogo, &ListingRow::gogo);
+  route(imports.net, &ListingRow::net);
+  route(imports.tix, &ListingRow::tix);
+
+  for (int i = 0; i < rows.size(); ++i) {
+    QString key = sectorKey(rows[i].sector);
+    if (!key.isEmpty() && !updated.contains(i) &&
+        rowsByKey.value(key).first() == i)
+      result.unmatchedRows.append(rows[i].sector.trimmed());
+  }
+  result.unmatchedImported.removeDuplicates();
+  result.updatedRows = int(updated.size());
+  return result;
+}
+
+QMap<QString, QString> ListingEngine::parseTixText(const QString &text) {
+  // Pattern:
+  // Line i: "E-ticket" (marker)
+  // Line i+1: Quantity (e.g., "2")
+  // Line i+2: "0"
+  // Line i+3: "All together"
+  // Line i+4-5: Numbers
+  // Line i+6: Sector name (e.g., "Terzo Anello Verde") - SKIP
+  // Line i+7: Block number (e.g., "358") - USE THIS
+  QStringList lines = text.split('\n', Qt::SkipEmptyParts);
+  QMap<QString, QString> inventory;
+
+  for (int i = 0; i < lines.size(); ++i) {
+    QString line = lines[i].trimmed();
+
+    // Look for "E-ticket" marker
+    if (line == "E-ticket" && i + 7 < lines.size()) {
+      // Quantity is next line
+      bool ok;
+      int qty = lines[i + 1].trimmed().toInt(&ok);
+      if (!ok || qty <= 0)
+        continue;
+
+      // Block number is at i+7 (after: qty, 0, "All together", 2 numbers,
+      // sector name)
+      QString blockNum = lines[i + 7].trimmed();
+
+      // Skip if it's "Row" or contains currency symbols
+      if (!blockNum.isEmpty() && blockNum != "Row" && !blockNum.contains("€") &&
+          !blockNum.contains("First")) {
+        if (inventory.contains(blockNum)) {
+          inventory[blockNum] += " + " + QString::number(qty);
+        } else {
+          inventory[blockNum] = QString::number(qty);
+        }
+      }
+    }
+  }
+
+  return inventory;
+}
+
+} // namespace GOL
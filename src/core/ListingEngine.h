@@ -0,0 +1,152 @@
+#ifndef LISTINGENGINE_H
+#define LISTINGENGINE_H
+
+#include "SectorResolver.h"
+#include "StockModel.h"
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+namespace GOL {
+
+// One line of the unified listing table (raw cell text)
+struct ListingRow {
+  QString sector;
+  QString gogo;
+  QString net;
+  QString tix;
+};
+
+// Stock allocation and marketplace imports behind CheckListing.
+class ListingEngine {
+public:
+  struct AllocationResult {
+    int grandTotal = 0;       // Sum of every listed quantity
+    QStringList danger;       // Sectors listed above available stock
+    QStringList missingStock; // Rows with unallocated tickets
+    QString text;             // Annotated stock report (empty on danger)
+    int splitListings = 0;    // Listings spread over more than one row
+    int timedOutSectors = 0;  // Sectors where the solver hit its budget
+    bool cancelled = false;   // Stopped by AllocationOptions::progress
+  };
+
+  // Listing table parsed once: platform -> sector (upper case) -> listed
+  // quantities. Read-only, so one copy serves every event of a batch.
+  struct ParsedListings {
+    QMap<QString, QMap<QString, QList<int>>> byPlatform;
+    int grandTotal = 0;
+  };
+
+  struct AllocationOptions {
+    // Search for the fewest split listings (then fewest partly used rows)
+    // instead of keeping the greedy result; the greedy one is the fallback
+    bool minimizeSplits = false;
+    int budgetMs = 50; // Per sector; the best solution so far is kept
+    // Called with (steps done, total steps) between passes and solver
+    // sectors; returning false cancels the allocation
+    std::function<bool(int, int)> progress;
+  };
+
+  // Allocate listings onto the rows of a CalcStock report. The model
+  // overload skips parsing; the text one is for edited or pasted reports.
+  static AllocationResult
+  allocate(const StockModel::Event &stock, const QList<ListingRow> &rows,
+           const AllocationOptions &options = AllocationOptions());
+  static AllocationResult
+  allocate(const QString &stockText, const QList<ListingRow> &rows,
+           const AllocationOptions &options = AllocationOptions());
+  // Shared core: report lines plus the row slots inside them
+  static AllocationResult
+  allocate(const QStringList &lines, const QList<StockModel::Slot> &slots,
+           const QList<ListingRow> &rows,
+           const AllocationOptions &options = AllocationOptions());
+  static AllocationResult
+  allocate(const QStringList &lines, const QList<StockModel::Slot> &slots,
+           const ParsedListings &listings,
+           const AllocationOptions &options = AllocationOptions());
+
+  static ParsedListings parseListings(const QList<ListingRow> &rows);
+
+  // Result as shown to the user: the stop list on danger, otherwise the
+  // annotated report followed by the missing-stock warnings
+  static QString formatResult(const AllocationResult &result);
+
+  // The same allocation as a background job on the global thread pool.
+  // Inputs are copied, so the caller's table can change meanwhile. The
+  // future reports progress; cancelling it stops the job between steps and
+  // leaves it without a result.
+  static QFuture<AllocationResult>
+  allocateAsync(const StockModel::Event &stock, const QList<ListingRow> &rows,
+                const AllocationOptions &options = AllocationOptions());
+  static QFuture<AllocationResult>
+  allocateAsync(const QString &stockText, const QList<ListingRow> &rows,
+                const AllocationOptions &options = AllocationOptions());
+
+  struct EventAllocation {
+    QString path;
+    QString name;
+    QString error; // StockEngine::ERROR_NO_TICKETS_FOLDER, empty if ok
+    AllocationResult result;
+  };
+
+  // CalcStock plus allocation for several event folders against the same
+  // listing table, parsed once. Each event is one task on the global
+  // thread pool; results keep the order of eventPaths. Cancelling stops
+  // before the next event. AllocationOptions::progress is not used.
+  static QFuture<EventAllocation>
+  allocateEvents(const QStringList &eventPaths, const QList<ListingRow> &rows,
+                 const AllocationOptions &options = AllocationOptions());
+  // One line per event plus its warnings
+  static QString batchSummary(const QList<EventAllocation> &events);
+
+  // Sector names found in a CalcStock report, in order, without duplicates
+  static QStringList sectorsFromReport(const QString &report);
+
+  // Importers: Sector -> "q1 + q2 + ..."
+  static QMap<QString, QString> parseGogoHtml(const QString &html,
+                                              int *foundRows = nullptr);
+  static QMap<QString, QString> parseNetHtml(const QString &html);
+  // Same on a saved page file, memory-mapped and scanned as UTF-8 bytes in
+  // one forward pass. Empty result and *error set if it cannot be opened.
+  static QMap<QString, QString> parseGogoFile(const QString &path,
+                                              int *foundRows = nullptr,
+                                              QString *error = nullptr);
+  static QMap<QString, QString> parseNetFile(const QString &path,
+                                             QString *error = nullptr);
+  static QMap<QString, QString> parseTixText(const QString &text);
+
+  // Importer results per platform; an empty map leaves its column alone
+  struct Imports {
+    QMap<QString, QString> gogo;
+    QMap<QString, QString> net;
+    QMap<QString, QString> tix;
+  };
+
+  struct ImportResult {
+    int updatedRows = 0;
+    QStringList unmatchedImported; // Imported sectors without a table row
+    QStringList unmatchedRows;     // Table sectors nothing was imported for
+  };
+
+  // Matching key of a sector name: case-folded, whitespace simplified
+  static QString sectorKey(const QString &sector);
+  // sectorKey(block) -> sectorKey(sector) from sector_db.json for one
+  // stadium context, so block-level listings reach a sector-level row
+  static QHash<QString, QString> sectorAliases(const SectorResolver &resolver,
+                                               const QString &context);
+  // Routes imported quantities onto the table in one pass over an index of
+  // its rows: same key first, then the alias. Several imported sectors on
+  // one row are joined with " + ".
+  static ImportResult applyImports(QList<ListingRow> &rows,
+                                   const Imports &imports,
+                                   const QHash<QString, QString> &aliases =
+                                       QHash<QString, QString>());
+};
+
+} // namespace GOL
+
+#endif // LISTINGENGINE_H
@@ -0,0 +1,213 @@
+#include "OrderEngine.h"
+#include <OpenXLSX.hpp>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <algorithm>
+#include <vector>
+
+namespace GOL {
+
+const QStringList OrderEngine::ALLOWED_COLUMNS = {"id", "transactionid",
+                                                  "order id", "orderid"};
+
+QStringList OrderEngine::parseCsvLine(const QString &line, QChar delim) {
+  QStringList list;
+  QString current;
+  bool inQuote = false;
+  for (int i = 0; i < line.length(); ++i) {
+    QChar c = line[i];
+    if (c == '"') {
+      if (i + 1 < line.length() && line[i + 1] == '"') {
+        current += '"';
+        i++; // Skip escaped quote
+      } else {
+        inQuote = !inQuote;
+      }
+    } else if (c == delim && !inQuote) {
+      list.append(current.trimmed());
+      current.clear();
+    } else {
+      current += c;
+    }
+  }
+  list.append(current.trimmed());
+  return list;
+}
+
+QString OrderEngine::cleanHeader(const QString &header) {
+  QString h = header.trimmed().replace("\"", "").toLower();
+  // Remove leading non-alphanumeric characters (Python behavior)
+  int i = 0;
+  while (i < h.length() && !h[i].isLetterOrNumber()) {
+    i++;
+  }
+  return h.mid(i);
+}
+
+QStringList OrderEngine::extractFromCsv(const QString &filePath) {
+  QStringList extracted;
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    return extracted;
+
+  QTextStream in(&file);
+  QString headerLine = in.readLine();
+  if (headerLine.isNull())
+    return extracted;
+
+  QChar delim = headerLine.contains('\t') ? '\t' : ',';
+  // Use robust parser for headers too
+  QStringList headers = parseCsvLine(headerLine, delim);
+
+  QList<int> idIndices;
+  for (int i = 0; i < headers.size(); ++i) {
+    if (ALLOWED_COLUMNS.contains(cleanHeader(headers[i]))) {
+      idIndices.append(i);
+    }
+  }
+
+  while (!in.atEnd()) {
+    QString line = in.readLine();
+    if (line.trimmed().isEmpty())
+      continue;
+
+    QStringList fields = parseCsvLine(line, delim);
+    for (int idx : idIndices) {
+      if (idx < fields.size()) {
+        QString val = fields[idx];
+        // Remove internal quotes if any left (usually handled by parser, but
+        // just in case)
+        val.remove('"');
+        if (val.length() >= 5)
+          extracted.append(val);
+      }
+    }
+  }
+  return extracted;
+}
+
+QStringList OrderEngine::extractFromExcel(const QString &filePath,
+                                          QString *error) {
+  QStringList extracted;
+  try {
+    OpenXLSX::XLDocument doc;
+    doc.open(filePath.toStdString());
+
+    auto sheetNames = doc.workbook().worksheetNames();
+    if (sheetNames.empty()) {
+      if (error)
+        *error = "❌ Excel Error: No sheets found in " +
+                 QFileInfo(filePath).fileName();
+      return extracted;
+    }
+
+    // Use the first sheet found
+    std::string firstSheet = sheetNames[0];
+    auto wks = doc.workbook().worksheet(firstSheet);
+
+    // Scan first 5 rows for header
+    int headerRow = -1;
+    std::vector<int> idIndices;
+    int colCount = wks.columnCount();
+    int rowCount = wks.rowCount();
+
+    for (int r = 1; r <= std::min(5, rowCount); ++r) {
+      bool foundAny = false;
+      for (int c = 1; c <= colCount; ++c) {
+        OpenXLSX::XLCell cell = wks.cell(r, c);
+        if (cell.value().type() == OpenXLSX::XLValueType::String) {
+          QString val = QString::fromStdString(cell.value().get<std::string>());
+          if (ALLOWED_COLUMNS.contains(cleanHeader(val))) {
+            idIndices.push_back(c);
+            foundAny = true;
+          }
+        }
+      }
+      if (foundAny) {
+        headerRow = r;
+        break;
+      }
+    }
+
+    if (headerRow == -1) {
+      // Require headers for safety rather than guessing ID columns
+      if (error)
+        *error = "⚠️ No valid specific header ('id', 'order id'...) found in "
+                 "first 5 rows of " +
+                 QFileInfo(filePath).fileName() + ". Checking all columns...";
+      return extracted;
+    }
+
+    // Iterate Rows starting after header
+    for (int r = headerRow + 1; r <= rowCount; ++r) {
+      for (int c : idIndices) {
+        OpenXLSX::XLCell cell = wks.cell(r, c);
+        QString val;
+        // Handle types
+        if (cell.value().type() == OpenXLSX::XLValueType::String)
+          val = QString::fromStdString(cell.value().get<std::string>());
+        else if (cell.value().type() == OpenXLSX::XLValueType::Integer)
+          val = QString::number(cell.value().get<int64_t>());
+        else if (cell.value().type() == OpenXLSX::XLValueType::Float)
+          val = QString::number(
+              (int64_t)cell.value()
+                  .get<double>()); // Handle float as int if it looks like ID
+
+        val = val.trimmed();
+        if (val.length() >= 5)
+          extracted.append(val);
+      }
+    }
+    doc.close();
+
+  } catch (const std::exception &e) {
+    if (error)
+      *error = "❌ Excel Error: " + QString::fromStdString(e.what());
+  }
+  return extracted;
+}
+
+QStringList OrderEngine::extractIds(const QString &path, QString *error) {
+  if (path.endsWith(".xlsx", Qt::CaseInsensitive))
+    return extractFromExcel(path, error);
+  return extractFromCsv(path);
+}
+
+OrderEngine::VerifyResult OrderEngine::verify(const QStringList &salesIds,
+                                              const QString &scanRoot) {
+  VerifyResult result;
+
+  QDirIterator it(scanRoot, QDir::Dirs | QDir::NoDotAndDotDot,
+                  QDirIterator::Subdirectories);
+  QStringList allLocalFolders;
+  while (it.hasNext()) {
+    allLocalFolders.append(it.next());
+  }
+
+  for (const QString &s_id : salesIds) {
+    QRegularExpression re("\\b" + QRegularExpression::escape(s_id) + "\\b",
+                          QRegularExpression::CaseInsensitiveOption);
+    for (const QString &folderPath : allLocalFolders) {
+      QString folderName = QFileInfo(folderPath).fileName();
+      if (re.match(folderName).hasMatch()) {
+        result.idMatches[s_id].append(folderName);
+      }
+    }
+  }
+
+  for (const QString &sid : salesIds) {
+    auto found = result.idMatches.constFind(sid);
+    if (found == result.idMatches.constEnd() || found.value().isEmpty()) {
+      result.missing.append(sid);
+    } else if (found.value().size() > 1) {
+      result.dupes[sid] = found.value();
+    }
+  }
+
+  return result;
+}
+
+} // namespace GOL
@@ -0,0 +1,41 @@
+#ifndef ORDERENGINE_H
+#define ORDERENGINE_H
+
+#include <QChar>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+namespace GOL {
+
+// Sales-file ID extraction and folder matching behind VerifyOrders.
+class OrderEngine {
+public:
+  struct VerifyResult {
+    QMap<QString, QStringList> idMatches;   // ID -> matching folder names
+    QStringList missing;                    // IDs with no folder
+    QMap<QString, QStringList> dupes;       // IDs found in several folders
+    int perfectMatches() const { return idMatches.size() - dupes.size(); }
+  };
+
+  static const QStringList ALLOWED_COLUMNS;
+
+  // Helper for parsing CSV properly (handling quotes)
+  static QStringList parseCsvLine(const QString &line, QChar delim);
+  static QString cleanHeader(const QString &header);
+
+  static QStringList extractFromCsv(const QString &path);
+  // On failure, returns what was read so far and fills *error if given
+  static QStringList extractFromExcel(const QString &path,
+                                      QString *error = nullptr);
+  // Dispatches on extension (.xlsx or CSV)
+  static QStringList extractIds(const QString &path, QString *error = nullptr);
+
+  // Match every sales ID against the folder names below scanRoot
+  static VerifyResult verify(const QStringList &salesIds,
+                             const QString &scanRoot);
+};
+
+} // namespace GOL
+
+#endif // ORDERENGINE_H
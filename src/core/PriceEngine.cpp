@@ -0,0 +1,1023 @@
+#include "PriceEngine.h"
+#include "HtmlTokenizer.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace GOL {
+
+double PriceEngine::cleanPrice(const QString &priceStr) {
+  if (priceStr.isEmpty())
+    return 0.0;
+
+  static const QRegularExpression nonNumeric("[^\\d\\.,]");
+  QString clean = priceStr;
+  clean.remove(nonNumeric);
+
+  if (clean.contains(',') && !clean.contains('.')) {
+    clean.replace(',', '.');
+  }
+
+  bool ok;
+  double val = clean.toDouble(&ok);
+  return ok ? val : 0.0;
+}
+
+using Tok = HtmlTokenizer::TokenType;
+
+// Text scanners for the FTN row fields; each returns false if the span
+// has no match so the caller keeps looking in the following spans
+
+// "Block: <value>", the value running to the end of the line
+static bool findBlock(QStringView text, QString *block) {
+  qsizetype from = 0;
+  qsizetype at;
+  while ((at = text.indexOf(QLatin1String("Block:"), from)) >= 0) {
+    qsizetype i = at + 6;
+    while (i < text.size() && text[i].isSpace())
+      ++i;
+    qsizetype end = i;
+    while (end < text.size() && text[end] != u'\n')
+      ++end;
+    if (end > i) {
+      *block = text.sliced(i, end - i).trimmed().toString();
+      return true;
+    }
+    from = at + 6;
+  }
+  return false;
+}
+
+// "€ 45,50" -> "45,50"
+static bool findEuroAmount(QStringView text, QString *amount) {
+  qsizetype from = 0;
+  qsizetype at;
+  while ((at = text.indexOf(QChar(0x20AC), from)) >= 0) {
+    qsizetype i = at + 1;
+    while (i < text.size() && text[i].isSpace())
+      ++i;
+    qsizetype end = i;
+    while (end < text.size() &&
+           (text[end].isDigit() || text[end] == u',' || text[end] == u'.'))
+      ++end;
+    if (end > i) {
+      *amount = text.sliced(i, end - i).toString();
+      return true;
+    }
+    from = at + 1;
+  }
+  return false;
+}
+
+// "Up To 4 Seats" -> 4
+static bool findUpToSeats(QStringView text, int *qty) {
+  const QLatin1String prefix("Up To ");
+  qsizetype from = 0;
+  qsizetype at;
+  while ((at = text.indexOf(prefix, from)) >= 0) {
+    qsizetype i = at + prefix.size();
+    qsizetype end = i;
+    while (end < text.size() && text[end].isDigit())
+      ++end;
+    if (end > i && text.sliced(end).startsWith(QLatin1String(" Seats"))) {
+      *qty = text.sliced(i, end - i).toInt();
+      return true;
+    }
+    from = at + 1;
+  }
+  return false;
+}
+
+static int digitsToInt(const QString &text) {
+  QString digits;
+  for (QChar c : text) {
+    if (c.isDigit())
+      digits.append(c);
+  }
+  return digits.toInt();
+}
+
+QList<Listing> PriceEngine::parseFTNHtml(const QString &html) {
+  QList<Listing> listings;
+
+  // A listing is the <div class="... stand_Sprice ... desktop ..."> block
+  // up to its matching </div>
+  HtmlTokenizer lexer(html);
+  int depth = 0; // Open divs inside the current listing, 0 outside
+  Listing listing;
+  enum { NoCategory, InCategory, CategoryDone } category = NoCategory;
+  QString categoryText;
+  bool hasBlock = false, hasPrice = false, hasQty = false;
+
+  for (auto t = lexer.next(); t.type != Tok::End; t = lexer.next()) {
+    const bool isDiv = t.isStart(QLatin1String("div"));
+
+    if (depth == 0) {
+      if (!isDiv || t.selfClosing)
+        continue;
+      QStringView cls = t.attribute(QLatin1String("class"));
+      qsizetype at = cls.indexOf(QLatin1String("stand_Sprice"));
+      if (at < 0 || cls.indexOf(QLatin1String("desktop"), at + 12) < 0)
+        continue;
+
+      depth = 1;
+      listing = Listing();
+      listing.quantity = 1;
+      listing.isOwned = t.raw.contains(QLatin1String("current_seller_ticket"));
+      category = NoCategory;
+      categoryText.clear();
+      hasBlock = hasPrice = hasQty = false;
+      continue;
+    }
+
+    if (t.type == Tok::Text) {
+      if (category == InCategory)
+        categoryText += t.raw;
+      QString price;
+      if (!hasBlock)
+        hasBlock = findBlock(t.raw, &listing.block);
+      if (!hasPrice && findEuroAmount(t.raw, &price)) {
+        listing.price = cleanPrice(price);
+        hasPrice = true;
+      }
+      if (!hasQty)
+        hasQty = findUpToSeats(t.raw, &listing.quantity);
+      continue;
+    }
+
+    if (t.raw.contains(QLatin1String("current_seller_ticket")))
+      listing.isOwned = true;
+
+    if (isDiv && !t.selfClosing) {
+      depth++;
+      if (category == NoCategory &&
+          t.attribute(QLatin1String("class"))
+              .contains(QLatin1String("category")))
+        category = InCategory;
+    } else if (t.isEnd(QLatin1String("div"))) {
+      if (category == InCategory) {
+        listing.category = categoryText.trimmed();
+        category = CategoryDone;
+      }
+      if (--depth == 0 && listing.price > 0)
+        listings.append(listing);
+    }
+  }
+
+  return listings;
+}
+
+QList<Listing> PriceEngine::parseTixstockHtml(const QString &html) {
+  QList<Listing> listings;
+
+  HtmlTokenizer lexer(html);
+  bool inRow = false;
+  bool inCell = false;
+  QString rowText;
+  QString cellText;
+  QStringList cells;
+
+  for (auto t = lexer.next(); t.type != Tok::End; t = lexer.next()) {
+    if (!inRow) {
+      if (t.isStart(QLatin1String("tr"))) {
+        inRow = true;
+        inCell = false;
+        rowText.clear();
+        cells.clear();
+      }
+      continue;
+    }
+
+    if (t.type == Tok::Text) {
+      rowText += t.raw;
+      if (inCell)
+        cellText += t.raw;
+    } else if (t.isStart(QLatin1String("td")) && !inCell) {
+      inCell = true;
+      cellText.clear();
+    } else if (t.isEnd(QLatin1String("td")) && inCell) {
+      cells.append(cellText.trimmed());
+      inCell = false;
+    } else if (t.isEnd(QLatin1String("tr"))) {
+      inRow = false;
+
+      // Header row
+      if (rowText.contains("Ticket Price") ||
+          rowText.contains("Section/Block"))
+        continue;
+      if (cells.size() < 6)
+        continue;
+
+      Listing listing;
+      listing.quantity = digitsToInt(cells[0]);
+      listing.category = cells[1];
+      listing.section = cells[2];
+      listing.row = cells[3];
+      listing.price = cleanPrice(cells[5]);
+      listing.isOwned = false;
+
+      if (listing.price > 0) {
+        listings.append(listing);
+      }
+    }
+  }
+
+  return listings;
+}
+
+QList<Listing> PriceEngine::parseViagogoHtml(const QString &html) {
+  QList<Listing> listings;
+
+  // Listing rows carry a class ("owned" marks ours); rows with <th> cells
+  // are headers
+  HtmlTokenizer lexer(html);
+  bool inRow = false;
+  bool inCell = false;
+  bool isHeader = false;
+  bool owned = false;
+  QString cellText;
+  QStringView inputValue;
+  QStringList cells;
+
+  for (auto t = lexer.next(); t.type != Tok::End; t = lexer.next()) {
+    if (!inRow) {
+      if (!t.isStart(QLatin1String("tr")))
+        continue;
+      QStringView cls = t.attribute(QLatin1String("class"));
+      if (cls.isNull())
+        continue;
+      inRow = true;
+      inCell = false;
+      isHeader = false;
+      owned = cls.contains(QLatin1String("owned"));
+      cells.clear();
+      continue;
+    }
+
+    if (t.type == Tok::Text) {
+      if (inCell)
+        cellText += t.raw;
+    } else if (t.type == Tok::StartTag &&
+               t.name.startsWith(QLatin1String("th"), Qt::CaseInsensitive)) {
+      isHeader = true;
+    } else if (t.isStart(QLatin1String("td")) && !inCell) {
+      inCell = true;
+      cellText.clear();
+      inputValue = QStringView();
+    } else if (t.isStart(QLatin1String("input")) && inCell &&
+               inputValue.isNull()) {
+      // Price cells are editable inputs; their value is the cell text
+      inputValue = t.attribute(QLatin1String("value"));
+    } else if (t.isEnd(QLatin1String("td")) && inCell) {
+      cells.append(inputValue.isNull() ? cellText.trimmed()
+                                       : inputValue.trimmed().toString());
+      inCell = false;
+    } else if (t.isEnd(QLatin1String("tr"))) {
+      inRow = false;
+      if (isHeader || cells.size() < 5)
+        continue;
+
+      Listing listing;
+      listing.isOwned = owned;
+      listing.section = cells.value(1);
+      listing.venueArea = cells.value(2);
+      listing.quantity = digitsToInt(cells.value(3));
+      listing.price = cleanPrice(cells.value(4));
+
+      if (listing.price > 0) {
+        listings.append(listing);
+      }
+    }
+  }
+
+  return listings;
+}
+
+// ---------------------------------------------------------
+// Comparison
+// ---------------------------------------------------------
+
+void MarketIndex::add(quint64 key, double price, int quantity) {
+  if (key == 0 || price <= 0.0)
+    return; // Unpriced rows never beat anyone
+  Prices &p = m_prices[key];
+  p.all.push_back(price);
+  if (quantity != 1)
+    p.multi.push_back(price);
+}
+
+void MarketIndex::build() {
+  for (Prices &p : m_prices) {
+    std::sort(p.all.begin(), p.all.end());
+    std::sort(p.multi.begin(), p.multi.end());
+  }
+}
+
+MarketPosition MarketIndex::position(quint64 key, double price,
+                                     int quantity) const {
+  MarketPosition pos;
+  auto it = m_prices.constFind(key);
+  if (it == m_prices.constEnd())
+    return pos;
+
+  const std::vector<double> &prices = quantity > 1 ? it->multi : it->all;
+  if (prices.empty())
+    return pos;
+
+  auto percentile = [&prices](int pct) {
+    size_t rank = (prices.size() * pct + 99) / 100; // ceil, 1-based
+    return prices[rank > 0 ? rank - 1 : 0];
+  };
+
+  pos.competitors = int(prices.size());
+  pos.best = prices.front();
+  pos.rank = 1 + int(std::lower_bound(prices.begin(), prices.end(),
+                                      price - 0.01) -
+                     prices.begin());
+  pos.gap = price - pos.best;
+  pos.p10 = percentile(10);
+  pos.p50 = percentile(50);
+  return pos;
+}
+
+// Case-insensitive string -> id table. Views point into the listings, which
+// outlive it, so interning allocates nothing per listing.
+class ListingInterner {
+public:
+  // 1-based id; 0 if absent and insert is false
+  int id(QStringView text, bool insert) {
+    auto it = m_ids.find(text);
+    if (it != m_ids.end())
+      return it->second;
+    if (!insert)
+      return 0;
+    int next = int(m_ids.size()) + 1;
+    m_ids.emplace(text, next);
+    return next;
+  }
+
+private:
+  struct Hash {
+    size_t operator()(QStringView text) const {
+      size_t h = 14695981039346656037ull; // FNV-1a over folded UTF-16
+      for (QChar c : text)
+        h = (h ^ c.toCaseFolded().unicode()) * 1099511628211ull;
+      return h;
+    }
+  };
+  struct Equal {
+    bool operator()(QStringView a, QStringView b) const {
+      return a.compare(b, Qt::CaseInsensitive) == 0;
+    }
+  };
+  std::unordered_map<QStringView, int, Hash, Equal> m_ids;
+};
+
+// Fields a comparison key is made of; second may be absent
+struct KeyFields {
+  QString Listing::*first;
+  QString Listing::*second;
+};
+
+// A report line describing the owned listing: "-<value> - <label>"
+struct ReportField {
+  QString Listing::*member;
+  const char *label;
+  const char *ifEmpty; // Printed instead of an empty value, if set
+};
+
+// LEFT_FILTER compares by block/section, RIGHT_FILTER by category/area.
+// The filter field is printed first, marked "(Filter)".
+// sectorFields: where the canonical sector is read from, most specific first.
+struct FtnPolicy {
+  static constexpr Platform platform = Platform::FTN;
+  static constexpr bool separateMarketPage = false;
+  static constexpr QString Listing::*sectorFields[2] = {&Listing::block,
+                                                        &Listing::category};
+  static constexpr KeyFields leftKey{&Listing::category, &Listing::block};
+  static constexpr KeyFields rightKey{&Listing::category, nullptr};
+  static constexpr ReportField leftReport[2] = {
+      {&Listing::block, "block", "No Block"},
+      {&Listing::category, "category", nullptr}};
+  static constexpr ReportField rightReport[2] = {
+      {&Listing::category, "category", nullptr},
+      {&Listing::block, "block", "No Block"}};
+
+  static QList<Listing> parse(const QString &html) {
+    return PriceEngine::parseFTNHtml(html);
+  }
+};
+
+// Our listings and the market come from two pages (Tixstock)
+struct TixstockPolicy {
+  static constexpr Platform platform = Platform::TIXSTOCK;
+  static constexpr bool separateMarketPage = true;
+  static constexpr QString Listing::*sectorFields[2] = {&Listing::section,
+                                                        &Listing::category};
+  static constexpr KeyFields leftKey{&Listing::category, &Listing::section};
+  static constexpr KeyFields rightKey{&Listing::category, nullptr};
+  static constexpr ReportField leftReport[2] = {
+      {&Listing::section, "section", nullptr},
+      {&Listing::category, "category", nullptr}};
+  static constexpr ReportField rightReport[2] = {
+      {&Listing::category, "category", nullptr},
+      {&Listing::section, "section", nullptr}};
+
+  static QList<Listing> parse(const QString &html) {
+    return PriceEngine::parseTixstockHtml(html);
+  }
+};
+
+struct ViagogoPolicy {
+  static constexpr Platform platform = Platform::VIAGOGO;
+  static constexpr bool separateMarketPage = false;
+  static constexpr QString Listing::*sectorFields[2] = {&Listing::section,
+                                                        &Listing::venueArea};
+  static constexpr KeyFields leftKey{&Listing::section, nullptr};
+  static constexpr KeyFields rightKey{&Listing::venueArea, nullptr};
+  static constexpr ReportField leftReport[2] = {
+      {&Listing::section, "section", nullptr},
+      {&Listing::venueArea, "venue area", nullptr}};
+  static constexpr ReportField rightReport[2] = {
+      {&Listing::venueArea, "venue area", nullptr},
+      {&Listing::section, "section", nullptr}};
+
+  static QList<Listing> parse(const QString &html) {
+    return PriceEngine::parseViagogoHtml(html);
+  }
+};
+
+// Canonical sector of a listing: the first of its sector fields the resolver
+// recognizes, else the first non-empty one as canonicalName leaves it. The
+// same few names repeat on every row; the resolver caches each one.
+class SectorMapper {
+public:
+  explicit SectorMapper(const SectorResolver &resolver)
+      : m_resolver(resolver) {}
+
+  QString sectorOf(const Listing &l, QString Listing::*const *fields) {
+    QString fallback;
+    for (int i = 0; i < 2; ++i) {
+      QString raw = (l.*fields[i]).trimmed();
+      if (raw.isEmpty())
+        continue;
+      QString sector;
+      if (m_resolver.resolve(raw, &sector))
+        return sector;
+      if (fallback.isEmpty())
+        fallback = sector;
+    }
+    return fallback;
+  }
+
+private:
+  const SectorResolver &m_resolver; // Memoizes its own lookups
+};
+
+template <typename Policy, CompareMode Mode>
+static QList<PriceCheck> compareListings(const QList<Listing> &owned,
+                                         const QList<Listing> &market,
+                                         const PriceFloors &floors) {
+  constexpr bool left = Mode == CompareMode::LEFT_FILTER;
+  static constexpr KeyFields key = left ? Policy::leftKey : Policy::rightKey;
+  static constexpr const ReportField *report =
+      left ? Policy::leftReport : Policy::rightReport;
+
+  // Key: the interned ids of one or two fields, packed
+  ListingInterner interner;
+  auto keyOf = [&interner](const Listing &l, bool insert) -> quint64 {
+    quint64 first = quint64(interner.id(l.*key.first, insert));
+    quint64 second = 1;
+    if constexpr (key.second != nullptr)
+      second = quint64(interner.id(l.*key.second, insert));
+    return (first == 0 || second == 0) ? 0 : (first << 32) | second;
+  };
+
+  MarketIndex index;
+  for (const auto &item : market)
+    index.add(keyOf(item, true), item.price, item.quantity);
+  index.build();
+
+  auto describe = [](const ReportField &field, const Listing &item) {
+    const QString &value = item.*field.member;
+    return (value.isEmpty() && field.ifEmpty) ? QString(field.ifEmpty) : value;
+  };
+
+  SectorMapper sectors(floors.resolver);
+  QList<PriceCheck> checks;
+  checks.reserve(owned.size());
+
+  for (const auto &item : owned) {
+    quint64 k = keyOf(item, false);
+
+    PriceCheck check;
+    check.filter = describe(report[0], item);
+    check.filterLabel = report[0].label;
+    check.detail = describe(report[1], item);
+    check.detailLabel = report[1].label;
+    check.price = item.price;
+    check.quantity = item.quantity;
+    check.position =
+        k ? index.position(k, item.price, item.quantity) : MarketPosition();
+    if (!floors.bySector.isEmpty())
+      check.floor = floors.bySector.value(
+          sectors.sectorOf(item, Policy::sectorFields), 0.0);
+    check.suggested =
+        PriceEngine::suggestPrice(check.position, check.price, check.floor);
+    checks.append(check);
+  }
+  return checks;
+}
+
+// Our listings and the market, from one platform's pages
+struct PlatformPages {
+  Platform platform = Platform::UNKNOWN;
+  QList<Listing> owned;
+  QList<Listing> market;
+  QString Listing::*const *sectorFields = nullptr; // Two entries
+};
+
+template <typename Policy>
+static PlatformPages loadPages(const QString &html1, const QString &html2) {
+  PlatformPages pages;
+  pages.platform = Policy::platform;
+  pages.sectorFields = Policy::sectorFields;
+
+  if constexpr (Policy::separateMarketPage) {
+    pages.owned = Policy::parse(html1);
+    pages.market = Policy::parse(html2);
+  } else {
+    for (const auto &l : Policy::parse(html1)) {
+      if (l.isOwned)
+        pages.owned.append(l);
+      else
+        pages.market.append(l);
+    }
+  }
+  return pages;
+}
+
+// One record per listing with a recognizable sector
+static void appendRecords(const PlatformPages &p, SectorMapper &sectors,
+                          QList<PriceRecord> &records) {
+  if (p.platform == Platform::UNKNOWN)
+    return;
+  for (const QList<Listing> *list : {&p.owned, &p.market}) {
+    for (const Listing &l : *list) {
+      PriceRecord record;
+      record.platform = p.platform;
+      record.sector = sectors.sectorOf(l, p.sectorFields);
+      record.price = l.price;
+      record.quantity = l.quantity;
+      record.owned = list == &p.owned;
+      if (!record.sector.isEmpty())
+        records.append(record);
+    }
+  }
+}
+
+template <typename Policy>
+static QList<PriceCheck> runCompare(CompareMode mode, const QString &html1,
+                                    const QString &html2,
+                                    const PriceFloors &floors,
+                                    QList<PriceRecord> *records) {
+  PlatformPages pages = loadPages<Policy>(html1, html2);
+  if (records) {
+    SectorMapper sectors(floors.resolver);
+    appendRecords(pages, sectors, *records);
+  }
+  return mode == CompareMode::LEFT_FILTER
+             ? compareListings<Policy, CompareMode::LEFT_FILTER>(
+                   pages.owned, pages.market, floors)
+             : compareListings<Policy, CompareMode::RIGHT_FILTER>(
+                   pages.owned, pages.market, floors);
+}
+
+QList<PriceCheck> PriceEngine::checkListings(Platform platform,
+                                             CompareMode mode,
+                                             const QString &html1,
+                                             const QString &html2,
+                                             const PriceFloors &floors,
+                                             QList<PriceRecord> *records) {
+  switch (platform) {
+  case Platform::FTN:
+    return runCompare<FtnPolicy>(mode, html1, html2, floors, records);
+  case Platform::TIXSTOCK:
+    return runCompare<TixstockPolicy>(mode, html1, html2, floors, records);
+  case Platform::VIAGOGO:
+    return runCompare<ViagogoPolicy>(mode, html1, html2, floors, records);
+  default:
+    return QList<PriceCheck>();
+  }
+}
+
+double PriceEngine::suggestPrice(const MarketPosition &position, double price,
+                                 double floor) {
+  // Already first (ties within a cent included): keep our price
+  double target =
+      position.competitors > 0 && position.rank > 1 ? position.best - 0.01
+                                                     : price;
+  return std::round(std::max(target, floor) * 100.0) / 100.0;
+}
+
+// "lower by 3.50 €", "raise by 2.00 €", "keep", or why we cannot be first
+static QString repricingAction(const PriceCheck &check) {
+  const MarketPosition &pos = check.position;
+  if (pos.competitors > 0 && check.suggested > pos.best + 0.01)
+    return "face value floor, cannot be first";
+  double delta = check.suggested - check.price;
+  if (delta < -0.005)
+    return QString("lower by %1 €").arg(-delta, 0, 'f', 2);
+  if (delta > 0.005)
+    return QString("raise by %1 €").arg(delta, 0, 'f', 2);
+  return "keep";
+}
+
+QString PriceEngine::formatReport(const QList<PriceCheck> &checks) {
+  if (checks.isEmpty()) {
+    return "No owned listings found. Please check the HTML file.";
+  }
+
+  QStringList reportLines;
+
+  for (const PriceCheck &check : checks) {
+    const MarketPosition &pos = check.position;
+    QString status = pos.rank > 1 ? "*NOT FIRST*" : "*FIRST*";
+
+    QString block;
+    block += QString("-%1 - %2 (Filter)\n")
+                 .arg(check.filter, check.filterLabel);
+    block += QString("-%1 - %2\n\n").arg(check.detail, check.detailLabel);
+
+    block += QString("-Our Price=%1 €\n").arg(check.price, 0, 'f', 2);
+    if (pos.competitors > 0) {
+      block += QString("-Comp Price=%1 €\n").arg(pos.best, 0, 'f', 2);
+      block += QString("-Rank=%1 of %2 (%3%4 € to first)\n")
+                   .arg(pos.rank)
+                   .arg(pos.competitors + 1)
+                   .arg(QString(pos.gap > 0 ? "+" : ""))
+                   .arg(pos.gap, 0, 'f', 2);
+      block += QString("-Market P10=%1 € / P50=%2 €\n")
+                   .arg(pos.p10, 0, 'f', 2)
+                   .arg(pos.p50, 0, 'f', 2);
+    } else {
+      block += "-Comp Price=NO COMPETITORS\n";
+    }
+    if (check.floor > 0)
+      block += QString("-FV Floor=%1 €\n").arg(check.floor, 0, 'f', 2);
+    block += QString("-Suggested=%1 € (%2)\n")
+                 .arg(check.suggested, 0, 'f', 2)
+                 .arg(repricingAction(check));
+    block += QString("%1\n").arg(status);
+    block += "---------------------------------";
+
+    reportLines.append(block);
+  }
+
+  return reportLines.join("\n");
+}
+
+QString PriceEngine::generateReport(Platform platform, CompareMode mode,
+                                   const QString &html1, const QString &html2,
+                                   const PriceFloors &floors) {
+  return formatReport(checkListings(platform, mode, html1, html2, floors));
+}
+
+static QString csvField(const QString &value) {
+  if (!value.contains(',') && !value.contains('"') && !value.contains('\n'))
+    return value;
+  QString quoted = value;
+  quoted.replace('"', "\"\"");
+  return '"' + quoted + '"';
+}
+
+QString PriceEngine::repricingCsv(Platform platform,
+                                  const QList<PriceCheck> &checks) {
+  QStringList lines;
+  lines << "platform,filter,detail,quantity,price,best,rank,competitors,p10,"
+           "p50,fv_floor,suggested,action";
+  for (const PriceCheck &c : checks) {
+    const MarketPosition &pos = c.position;
+    QStringList fields;
+    fields << platformName(platform) << csvField(c.filter)
+           << csvField(c.detail) << QString::number(c.quantity)
+           << QString::number(c.price, 'f', 2)
+           << QString::number(pos.best, 'f', 2) << QString::number(pos.rank)
+           << QString::number(pos.competitors)
+           << QString::number(pos.p10, 'f', 2)
+           << QString::number(pos.p50, 'f', 2)
+           << QString::number(c.floor, 'f', 2)
+           << QString::number(c.suggested, 'f', 2)
+           << csvField(repricingAction(c));
+    lines << fields.join(',');
+  }
+  return lines.join("\n") + "\n";
+}
+
+PriceFloors PriceEngine::faceValueFloors(const StockModel::Event &stock,
+                                         const SectorResolver &resolver) {
+  PriceFloors floors;
+  floors.resolver = resolver;
+  for (const StockModel::Category &category : stock.categories) {
+    for (const StockModel::Sector &sector : category.sectors) {
+      QString name = resolver.canonicalName(sector.name);
+      for (const StockModel::Row &row : sector.rows) {
+        double fv = cleanPrice(row.price); // "45.50€"; "N/A" gives 0
+        if (fv > floors.bySector.value(name, 0.0))
+          floors.bySector.insert(name, fv);
+      }
+    }
+  }
+  return floors;
+}
+
+QString PriceEngine::platformName(Platform platform) {
+  switch (platform) {
+  case Platform::FTN:
+    return "FTN";
+  case Platform::TIXSTOCK:
+    return "Tixstock";
+  case Platform::VIAGOGO:
+    return "Viagogo";
+  default:
+    return "Unknown";
+  }
+}
+
+static PlatformPages loadSnapshot(const MarketSnapshot &snapshot) {
+  switch (snapshot.platform) {
+  case Platform::FTN:
+    return loadPages<FtnPolicy>(snapshot.html, snapshot.marketHtml);
+  case Platform::TIXSTOCK:
+    return loadPages<TixstockPolicy>(snapshot.html, snapshot.marketHtml);
+  case Platform::VIAGOGO:
+    return loadPages<ViagogoPolicy>(snapshot.html, snapshot.marketHtml);
+  default:
+    return PlatformPages();
+  }
+}
+
+QList<PriceRecord>
+PriceEngine::sectorRecords(const QList<MarketSnapshot> &snapshots,
+                           const SectorResolver &resolver) {
+  // blockingMapped keeps input order, so the records stay deterministic
+  QList<PlatformPages> pages =
+      QtConcurrent::blockingMapped<QList<PlatformPages>>(snapshots,
+                                                         loadSnapshot);
+
+  SectorMapper sectors(resolver);
+  QList<PriceRecord> records;
+  for (const PlatformPages &p : pages)
+    appendRecords(p, sectors, records);
+  return records;
+}
+
+QList<SectorStanding>
+PriceEngine::unifiedView(const QList<MarketSnapshot> &snapshots,
+                         const SectorResolver &resolver) {
+  return unifiedView(sectorRecords(snapshots, resolver));
+}
+
+QList<SectorStanding>
+PriceEngine::unifiedView(const QList<PriceRecord> &records) {
+  QHash<QString, quint64> sectorIds;
+  auto idOf = [&sectorIds](const QString &sector) {
+    auto it = sectorIds.constFind(sector);
+    if (it == sectorIds.constEnd())
+      it = sectorIds.insert(sector, quint64(sectorIds.size()) + 1);
+    return it.value();
+  };
+
+  // One index per platform, keyed by canonical sector
+  QMap<int, MarketIndex> indexes;
+  QMap<QString, QMap<int, QList<const PriceRecord *>>> ownedBySector;
+  for (const PriceRecord &r : records) {
+    MarketIndex &index = indexes[int(r.platform)];
+    if (r.owned)
+      ownedBySector[r.sector][int(r.platform)].append(&r);
+    else
+      index.add(idOf(r.sector), r.price, r.quantity);
+  }
+  for (MarketIndex &index : indexes)
+    index.build();
+
+  QList<SectorStanding> standings;
+  for (auto sit = ownedBySector.constBegin(); sit != ownedBySector.constEnd();
+       ++sit) {
+    quint64 id = idOf(sit.key());
+    for (auto pit = indexes.constBegin(); pit != indexes.constEnd(); ++pit) {
+      SectorStanding standing;
+      standing.sector = sit.key();
+      standing.platform = Platform(pit.key());
+
+      const QList<const PriceRecord *> owned = sit->value(pit.key());
+      if (owned.isEmpty()) {
+        standing.position = pit->position(id, 0.0, 1); // Market only
+        standings.append(standing);
+        continue;
+      }
+      for (const PriceRecord *r : owned) {
+        standing.listed = true;
+        standing.price = r->price;
+        standing.quantity = r->quantity;
+        standing.position = pit->position(id, r->price, r->quantity);
+        standings.append(standing);
+      }
+    }
+  }
+  return standings;
+}
+
+QString
+PriceEngine::formatUnifiedView(const QList<SectorStanding> &standings) {
+  if (standings.isEmpty())
+    return "No owned listings found. Please check the HTML files.";
+
+  QStringList lines;
+  QString sector;
+  for (const SectorStanding &s : standings) {
+    if (s.sector != sector) {
+      if (!sector.isEmpty())
+        lines << "---------------------------------";
+      sector = s.sector;
+      lines << QString("=== %1 ===").arg(sector);
+    }
+
+    const MarketPosition &pos = s.position;
+    QString line = platformName(s.platform).leftJustified(10);
+    if (!s.listed) {
+      line += pos.competitors > 0
+                  ? QString("not listed - market from %1 € (%2 listings)")
+                        .arg(pos.best, 0, 'f', 2)
+                        .arg(pos.competitors)
+                  : QString("not listed - no market");
+    } else if (pos.competitors == 0) {
+      line += QString("%1 x %2 € - NO COMPETITORS *FIRST*")
+                  .arg(s.quantity)
+                  .arg(s.price, 0, 'f', 2);
+    } else {
+      line += QString("%1 x %2 € - rank %3 of %4 (%5%6 € to first), "
+                      "P10 %7 € / P50 %8 € %9")
+                  .arg(s.quantity)
+                  .arg(s.price, 0, 'f', 2)
+                  .arg(pos.rank)
+                  .arg(pos.competitors + 1)
+                  .arg(QString(pos.gap > 0 ? "+" : ""))
+                  .arg(pos.gap, 0, 'f', 2)
+                  .arg(pos.p10, 0, 'f', 2)
+                  .arg(pos.p50, 0, 'f', 2)
+                  .arg(QString(pos.rank > 1 ? "*NOT FIRST*" : "*FIRST*"));
+    }
+    lines << line;
+  }
+  return lines.join("\n");
+}
+
+Platform PriceEngine::detectPlatform(const QString &html) {
+  if (html.contains(QLatin1String("stand_Sprice")) ||
+      html.contains(QLatin1String("footballticketnet"), Qt::CaseInsensitive))
+    return Platform::FTN;
+  if (html.contains(QLatin1String("tixstock"), Qt::CaseInsensitive))
+    return Platform::TIXSTOCK;
+  if (html.contains(QLatin1String("viagogo"), Qt::CaseInsensitive))
+    return Platform::VIAGOGO;
+  return Platform::UNKNOWN;
+}
+
+QList<PageCheck> PriceEngine::batchPages(const QString &folder) {
+  static const QRegularExpression listingsTag(
+      "(?<![[:alpha:]])(all|my)[ _-]*listings?(?![[:alpha:]])",
+      QRegularExpression::CaseInsensitiveOption);
+  static const QRegularExpression separators("[ _-]+");
+
+  QDir dir(folder);
+  const QStringList files =
+      dir.entryList({"*.html", "*.htm"}, QDir::Files, QDir::Name);
+
+  // Pages keyed by their name without the listings tag
+  auto pairKey = [](const QString &file) {
+    QString key = QFileInfo(file).completeBaseName();
+    key.remove(listingsTag);
+    return key.replace(separators, " ").trimmed().toLower();
+  };
+
+  // "all" or "my" for a Tixstock page, empty for any other
+  auto tagOf = [](const QString &file) {
+    QRegularExpressionMatch m = listingsTag.match(file);
+    return m.hasMatch() ? m.captured(1).toLower() : QString();
+  };
+
+  QList<PageCheck> pages;
+  QHash<QString, QString> allListings; // Pair key -> path, until claimed
+  for (const QString &file : files) {
+    if (tagOf(file) == "all")
+      allListings.insert(pairKey(file), dir.filePath(file));
+  }
+  for (const QString &file : files) {
+    const QString tag = tagOf(file);
+    if (tag == "all")
+      continue;
+    PageCheck page;
+    page.path = dir.filePath(file);
+    // Only "My Listings" pages claim; "Event X.html" from FTN must not
+    if (tag == "my")
+      page.marketPath = allListings.take(pairKey(file));
+    pages.append(page);
+  }
+  // An "All Listings" page alone has no listings of ours to check
+  for (const QString &path : std::as_const(allListings)) {
+    PageCheck page;
+    page.path = path;
+    page.platform = Platform::TIXSTOCK;
+    page.error = "All Listings page without its My Listings page";
+    pages.append(page);
+  }
+  return pages;
+}
+
+static bool readHtml(const QString &path, QString &html, QString &error) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    error = file.errorString();
+    return false;
+  }
+  html = QString::fromUtf8(file.readAll());
+  return true;
+}
+
+QFuture<PageCheck> PriceEngine::checkPages(const QList<PageCheck> &pages,
+                                           CompareMode mode,
+                                           const PriceFloors &floors) {
+  // Each task works on its own copy: the resolver memoizes lookups
+  return QtConcurrent::mapped(pages, [mode, floors](PageCheck page) {
+    if (!page.error.isEmpty())
+      return page; // Left out by batchPages
+    QString html;
+    if (!readHtml(page.path, html, page.error))
+      return page;
+    page.platform = detectPlatform(html);
+
+    QString marketHtml;
+    if (page.platform == Platform::UNKNOWN) {
+      page.error = "Platform not recognized";
+    } else if (page.platform == Platform::TIXSTOCK) {
+      if (page.marketPath.isEmpty())
+        page.error = "Tixstock page without its All Listings page";
+      else
+        readHtml(page.marketPath, marketHtml, page.error);
+    }
+    if (page.error.isEmpty())
+      page.checks = checkListings(page.platform, mode, html, marketHtml,
+                                  PriceFloors(floors), &page.records);
+    return page;
+  });
+}
+
+QString PriceEngine::batchReport(const QList<PageCheck> &pages) {
+  QStringList lines;
+  lines << QString("📚 BATCH: %1 pages").arg(pages.size());
+  lines << "========================================";
+
+  int notFirstTotal = 0;
+  QStringList details;
+  for (const PageCheck &page : pages) {
+    QString name = QFileInfo(page.path).fileName();
+    if (!page.error.isEmpty()) {
+      lines << QString("❌ %1: %2").arg(name, page.error);
+      continue;
+    }
+    if (page.checks.isEmpty()) {
+      lines << QString("❌ %1 [%2]: no owned listings found")
+                   .arg(name, platformName(page.platform));
+      continue;
+    }
+
+    int notFirst = 0;
+    for (const PriceCheck &c : page.checks)
+      notFirst += c.position.rank > 1 ? 1 : 0;
+    notFirstTotal += notFirst;
+    lines << QString("%1 %2 [%3]: %4 listings, %5 NOT FIRST")
+                 .arg(QString(notFirst > 0 ? "⚠️" : "✅"), name,
+                      platformName(page.platform))
+                 .arg(page.checks.size())
+                 .arg(notFirst);
+
+    details << "";
+    details << QString("=== %1 [%2] ===")
+                   .arg(name, platformName(page.platform));
+    details << formatReport(page.checks);
+  }
+
+  lines << "";
+  lines << QString("%1 listings NOT FIRST").arg(notFirstTotal);
+  return (lines + details).join('\n');
+}
+
+} // namespace GOL
@@ -0,0 +1,197 @@
+#ifndef PRICEENGINE_H
+#define PRICEENGINE_H
+
+#include "SectorResolver.h"
+#include "StockModel.h"
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <vector>
+
+namespace GOL {
+
+// Platform types
+enum class Platform {
+  FTN,      // Football Ticket Net
+  TIXSTOCK, // Tixstock
+  VIAGOGO,  // Viagogo
+  UNKNOWN
+};
+
+// Comparison modes
+enum class CompareMode {
+  LEFT_FILTER, // Compare by Block/Section
+  RIGHT_FILTER // Compare by Category/Venue Area
+};
+
+// Listing data structure
+struct Listing {
+  bool isOwned = false;
+  QString category;
+  QString block;
+  QString section;
+  QString row;
+  QString venueArea;
+  double price = 0.0;
+  int quantity = 0;
+};
+
+// Where a price would sit among the comparable market listings
+struct MarketPosition {
+  int competitors = 0; // Comparable market listings
+  int rank = 1;        // 1 = cheapest; ties within 0.01 count as level
+  double best = 0.0;   // Cheapest comparable price (0 if none)
+  double gap = 0.0;    // Price minus best; negative when we undercut
+  double p10 = 0.0;    // 10th / 50th percentile (nearest rank)
+  double p50 = 0.0;
+};
+
+// Market prices per comparison key, sorted once and split by quantity class.
+// Multi-ticket listings only compete with listings that are not singles;
+// everything else competes with the whole key. Lookups are O(log n).
+class MarketIndex {
+public:
+  void add(quint64 key, double price, int quantity);
+  void build(); // Call once after the last add()
+
+  MarketPosition position(quint64 key, double price, int quantity) const;
+
+private:
+  struct Prices {
+    std::vector<double> all;
+    std::vector<double> multi; // Quantity other than 1
+  };
+  QHash<quint64, Prices> m_prices;
+};
+
+// Lowest asking price per canonical sector: the highest face value ("-FV"
+// in the ticket filenames) of our stock there
+struct PriceFloors {
+  QHash<QString, double> bySector;
+  SectorResolver resolver; // Maps listings onto those sectors
+};
+
+// One owned listing against its market: a block of the text report and a
+// line of the repricing export
+struct PriceCheck {
+  QString filter; // Filter field ("No Block" etc. when empty)
+  QString filterLabel;
+  QString detail; // The other field of the key
+  QString detailLabel;
+  double price = 0.0;
+  int quantity = 0;
+  MarketPosition position;
+  double floor = 0.0;     // Face value floor, 0 if unknown
+  double suggested = 0.0; // PriceEngine::suggestPrice
+};
+
+// One platform's saved pages for the unified view; marketHtml is only used
+// by Tixstock (All Listings page)
+struct MarketSnapshot {
+  Platform platform = Platform::UNKNOWN;
+  QString html;
+  QString marketHtml;
+};
+
+// One parsed listing under its canonical sector
+struct PriceRecord {
+  Platform platform = Platform::UNKNOWN;
+  QString sector; // SectorResolver::canonicalName
+  double price = 0.0;
+  int quantity = 0;
+  bool owned = false;
+};
+
+// Our standing on one platform in one canonical sector. When we have no
+// listing there, position describes the market alone.
+struct SectorStanding {
+  QString sector; // SectorResolver::canonicalName
+  Platform platform = Platform::UNKNOWN;
+  bool listed = false;
+  double price = 0.0;
+  int quantity = 0;
+  MarketPosition position;
+};
+
+// One saved page of a batch folder
+struct PageCheck {
+  QString path;
+  QString marketPath; // Tixstock "All Listings" page paired by name
+  Platform platform = Platform::UNKNOWN; // Detected from the content
+  QString error;
+  QList<PriceCheck> checks;
+  QList<PriceRecord> records; // The parsed page, for the price history
+};
+
+// Market page parsers and the FIRST / NOT FIRST comparison behind CheckPrice.
+class PriceEngine {
+public:
+  // html2 is only used by Tixstock (All Listings page)
+  static QString generateReport(Platform platform, CompareMode mode,
+                                const QString &html1,
+                                const QString &html2 = QString(),
+                                const PriceFloors &floors = PriceFloors());
+  // generateReport before formatting, one check per owned listing. If
+  // records is given it also receives the parsed pages as sectorRecords
+  // would build them (sectors from floors.resolver), without a second parse.
+  static QList<PriceCheck>
+  checkListings(Platform platform, CompareMode mode, const QString &html1,
+                const QString &html2 = QString(),
+                const PriceFloors &floors = PriceFloors(),
+                QList<PriceRecord> *records = nullptr);
+  static QString formatReport(const QList<PriceCheck> &checks);
+
+  // Price that makes a listing first: one cent under the cheapest
+  // comparable offer (singles never count against multi-ticket listings).
+  // A listing that is already first, or has no competitors, keeps its
+  // price. Never below floor.
+  static double suggestPrice(const MarketPosition &position, double price,
+                             double floor);
+  // Repricing export: header plus one CSV line per check
+  static QString repricingCsv(Platform platform,
+                              const QList<PriceCheck> &checks);
+  static PriceFloors faceValueFloors(const StockModel::Event &stock,
+                                     const SectorResolver &resolver);
+
+  // All platforms at once: pages are parsed concurrently, block / section /
+  // category are mapped onto canonical sectors and every sector we list in
+  // gets one standing per platform. Sorted by sector, then platform.
+  static QList<SectorStanding>
+  unifiedView(const QList<MarketSnapshot> &snapshots,
+              const SectorResolver &resolver);
+  static QList<SectorStanding> unifiedView(const QList<PriceRecord> &records);
+  // The parsed pages behind unifiedView, one record per listing
+  static QList<PriceRecord>
+  sectorRecords(const QList<MarketSnapshot> &snapshots,
+                const SectorResolver &resolver);
+  static QString formatUnifiedView(const QList<SectorStanding> &standings);
+
+  static QString platformName(Platform platform);
+  // From the page content (site markers); UNKNOWN if none matches
+  static Platform detectPlatform(const QString &html);
+
+  // The *.html pages of a folder, by name. A Tixstock "... All Listings"
+  // page is attached to the "... My Listings" page of the same name; one
+  // left over comes back with an error.
+  static QList<PageCheck> batchPages(const QString &folder);
+  // Reads, detects and checks each page as one task on the global thread
+  // pool; results keep the order of pages. Cancelling stops before the
+  // next page. Every page uses floors, its resolver also sectors records.
+  static QFuture<PageCheck>
+  checkPages(const QList<PageCheck> &pages, CompareMode mode,
+             const PriceFloors &floors = PriceFloors());
+  // One line per page, then each page's report
+  static QString batchReport(const QList<PageCheck> &pages);
+
+  // Platform-specific parsers
+  static QList<Listing> parseFTNHtml(const QString &html);
+  static QList<Listing> parseTixstockHtml(const QString &html);
+  static QList<Listing> parseViagogoHtml(const QString &html);
+
+  static double cleanPrice(const QString &priceStr);
+};
+
+} // namespace GOL
+
+#endif // PRICEENGINE_H
@@ -0,0 +1,340 @@
+#include "PriceHistory.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace GOL {
+
+static const char FILE_MAGIC[8] = {'G', 'O', 'L', 'P', 'H', '1', 0, 0};
+static const char BLOCK_MAGIC[4] = {'S', 'N', 'A', 'P'};
+static constexpr qsizetype HEADER_BYTES = 32;
+static constexpr qint64 DAY_MS = 24 * 60 * 60 * 1000LL;
+
+static qsizetype padded(qsizetype n) { return (n + 7) & ~qsizetype(7); }
+
+static quint32 readU32(const uchar *p) { return qFromLittleEndian<quint32>(p); }
+
+static qsizetype blockBytes(quint32 rows, quint32 dictSize, quint32 nameBytes) {
+  return HEADER_BYTES + padded(4 * (qsizetype(dictSize) + 1) + nameBytes) +
+         16 * qsizetype(rows) + padded(rows);
+}
+
+// One complete block inside the mapped file; columns are read in place
+struct BlockView {
+  qint64 timestampMs = 0;
+  Platform platform = Platform::UNKNOWN;
+  quint32 rows = 0;
+  quint32 dictSize = 0;
+  quint32 nameBytes = 0;
+  const uchar *offsets = nullptr;
+  const uchar *names = nullptr;
+  const uchar *prices = nullptr;
+  const uchar *sectors = nullptr;
+  const uchar *quantities = nullptr;
+  const uchar *owned = nullptr;
+
+  QString name(quint32 i) const {
+    quint32 from = readU32(offsets + 4 * i);
+    quint32 to = readU32(offsets + 4 * (i + 1));
+    if (from > to || to > nameBytes)
+      return QString();
+    return QString::fromUtf8(reinterpret_cast<const char *>(names) + from,
+                             to - from);
+  }
+  // Dictionary index of a sector, or dictSize if the page has none of it
+  quint32 find(const QString &sector) const {
+    for (quint32 i = 0; i < dictSize; ++i)
+      if (name(i).compare(sector, Qt::CaseInsensitive) == 0)
+        return i;
+    return dictSize;
+  }
+  double price(quint32 row) const {
+    quint64 bits = qFromLittleEndian<quint64>(prices + 8 * qsizetype(row));
+    double value;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+  }
+  quint32 sector(quint32 row) const {
+    return readU32(sectors + 4 * qsizetype(row));
+  }
+  int quantity(quint32 row) const {
+    return int(readU32(quantities + 4 * qsizetype(row)));
+  }
+  bool isOwned(quint32 row) const { return owned[row] != 0; }
+};
+
+// Reads the block at offset; false if it is missing, torn or corrupt
+static bool readBlock(const uchar *data, qsizetype size, qsizetype offset,
+                      BlockView &block, qsizetype &next) {
+  if (size - offset < HEADER_BYTES)
+    return false;
+  const uchar *h = data + offset;
+  if (std::memcmp(h, BLOCK_MAGIC, 4) != 0)
+    return false;
+
+  qsizetype bytes = readU32(h + 4);
+  block.timestampMs = qFromLittleEndian<qint64>(h + 8);
+  block.rows = readU32(h + 16);
+  block.dictSize = readU32(h + 20);
+  block.platform = Platform(readU32(h + 24));
+
+  qsizetype offsetBytes = 4 * (qsizetype(block.dictSize) + 1);
+  if (bytes > size - offset || HEADER_BYTES + offsetBytes > bytes)
+    return false;
+  block.offsets = h + HEADER_BYTES;
+  block.nameBytes = readU32(block.offsets + 4 * qsizetype(block.dictSize));
+  if (blockBytes(block.rows, block.dictSize, block.nameBytes) != bytes)
+    return false;
+
+  block.names = block.offsets + offsetBytes;
+  block.prices = block.offsets + padded(offsetBytes + block.nameBytes);
+  block.sectors = block.prices + 8 * qsizetype(block.rows);
+  block.quantities = block.sectors + 4 * qsizetype(block.rows);
+  block.owned = block.quantities + 4 * qsizetype(block.rows);
+  next = offset + bytes;
+  return true;
+}
+
+// Maps the file and visits every complete block in file order. validEnd is
+// where the last complete block ends (0 if the file has no header yet). A
+// missing file is an empty history.
+static bool scanHistory(const QString &path, QString *error,
+                        const std::function<void(const BlockView &)> &visit,
+                        qsizetype *validEnd = nullptr) {
+  if (validEnd)
+    *validEnd = 0;
+  QFile file(path);
+  if (!file.exists() || file.size() == 0)
+    return true;
+  if (!file.open(QIODevice::ReadOnly)) {
+    if (error)
+      *error = file.errorString();
+    return false;
+  }
+
+  auto scan = [&](const uchar *data, qsizetype size) {
+    if (size < qsizetype(sizeof FILE_MAGIC) ||
+        std::memcmp(data, FILE_MAGIC, sizeof FILE_MAGIC) != 0) {
+      if (error)
+        *error = "Not a price history file: " + path;
+      return false;
+    }
+    qsizetype offset = sizeof FILE_MAGIC;
+    BlockView block;
+    qsizetype next = 0;
+    while (readBlock(data, size, offset, block, next)) {
+      visit(block);
+      offset = next;
+    }
+    if (validEnd)
+      *validEnd = offset;
+    return true;
+  };
+
+  if (uchar *map = file.map(0, file.size())) {
+    bool ok = scan(map, file.size());
+    file.unmap(map);
+    return ok;
+  }
+  QByteArray data = file.readAll();
+  return scan(reinterpret_cast<const uchar *>(data.constData()), data.size());
+}
+
+QString PriceHistoryStore::pathForEvent(const QString &eventName) {
+  static const QRegularExpression unsafe("[\\\\/:*?\"<>|]");
+  QString name = eventName.trimmed();
+  name.replace(unsafe, "_");
+  if (name.isEmpty())
+    name = "unnamed";
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+         "/price_history/" + name + ".golph";
+}
+
+bool PriceHistoryStore::append(qint64 timestampMs, Platform platform,
+                               const QList<PriceRecord> &records,
+                               QString *error) {
+  bool stored = false;
+  qsizetype validEnd = 0;
+  if (!scanHistory(
+          m_path, error,
+          [&](const BlockView &b) {
+            if (b.timestampMs == timestampMs && b.platform == platform)
+              stored = true;
+          },
+          &validEnd))
+    return false;
+  if (stored)
+    return true;
+
+  // Dictionary: this page's sectors in first-seen order
+  QHash<QString, quint32> ids;
+  QByteArray names;
+  QList<quint32> offsets{0};
+  for (const PriceRecord &r : records) {
+    if (ids.contains(r.sector))
+      continue;
+    ids.insert(r.sector, quint32(ids.size()));
+    names += r.sector.toUtf8();
+    offsets.append(quint32(names.size()));
+  }
+
+  const quint32 rows = quint32(records.size());
+  const qsizetype bytes =
+      blockBytes(rows, quint32(ids.size()), quint32(names.size()));
+  QByteArray block;
+  block.reserve(bytes);
+  auto put32 = [&block](quint32 v) {
+    char b[4];
+    qToLittleEndian(v, b);
+    block.append(b, 4);
+  };
+  auto put64 = [&block](quint64 v) {
+    char b[8];
+    qToLittleEndian(v, b);
+    block.append(b, 8);
+  };
+  auto pad = [&block] {
+    block.append(padded(block.size()) - block.size(), '\0');
+  };
+
+  block.append(BLOCK_MAGIC, 4);
+  put32(quint32(bytes));
+  put64(quint64(timestampMs));
+  put32(rows);
+  put32(quint32(ids.size()));
+  put32(quint32(platform));
+  put32(0); // Reserved
+  for (quint32 offset : offsets)
+    put32(offset);
+  block += names;
+  pad();
+  for (const PriceRecord &r : records) {
+    quint64 bits;
+    std::memcpy(&bits, &r.price, sizeof bits);
+    put64(bits);
+  }
+  for (const PriceRecord &r : records)
+    put32(ids.value(r.sector));
+  for (const PriceRecord &r : records)
+    put32(quint32(qMax(0, r.quantity)));
+  for (const PriceRecord &r : records)
+    block.append(char(r.owned ? 1 : 0));
+  pad();
+  Q_ASSERT(block.size() == bytes);
+
+  QDir().mkpath(QFileInfo(m_path).absolutePath());
+  QFile file(m_path);
+  if (!file.open(QIODevice::ReadWrite)) {
+    if (error)
+      *error = file.errorString();
+    return false;
+  }
+  if (validEnd == 0) {
+    file.resize(0);
+    file.write(FILE_MAGIC, sizeof FILE_MAGIC);
+  } else if (file.size() != validEnd) {
+    file.resize(validEnd); // Torn tail of an interrupted append
+  }
+  file.seek(file.size());
+  if (file.write(block) != block.size()) {
+    if (error)
+      *error = file.errorString();
+    return false;
+  }
+  return true;
+}
+
+QList<PriceHistoryStore::FloorPoint>
+PriceHistoryStore::floorHistory(const QString &sector, Platform platform,
+                                QString *error) const {
+  QList<FloorPoint> points;
+  scanHistory(m_path, error, [&](const BlockView &b) {
+    if (platform != Platform::UNKNOWN && b.platform != platform)
+      return;
+    quint32 id = b.find(sector);
+    if (id == b.dictSize)
+      return;
+
+    FloorPoint point;
+    point.timestampMs = b.timestampMs;
+    point.platform = b.platform;
+    for (quint32 row = 0; row < b.rows; ++row) {
+      if (b.sector(row) != id || b.isOwned(row))
+        continue;
+      double price = b.price(row);
+      if (price <= 0.0)
+        continue;
+      if (point.competitors++ == 0 || price < point.floor)
+        point.floor = price;
+    }
+    if (point.competitors > 0)
+      points.append(point);
+  });
+
+  // Appended in check order, which need not be the order pages were saved
+  std::stable_sort(points.begin(), points.end(),
+                   [](const FloorPoint &a, const FloorPoint &b) {
+                     return a.timestampMs < b.timestampMs;
+                   });
+  return points;
+}
+
+PriceHistoryStore::FloorTrend
+PriceHistoryStore::floorTrend(const QString &sector, const QDateTime &kickoff,
+                              int days, Platform platform,
+                              QString *error) const {
+  FloorTrend trend;
+  const qint64 end = kickoff.toMSecsSinceEpoch();
+  const qint64 start = end - qint64(days) * DAY_MS;
+  for (const FloorPoint &p : floorHistory(sector, platform, error))
+    if (p.timestampMs >= start && p.timestampMs <= end)
+      trend.points.append(p);
+  if (trend.points.isEmpty())
+    return trend;
+
+  trend.firstFloor = trend.points.first().floor;
+  trend.lastFloor = trend.points.last().floor;
+
+  // Least squares of floor over days to kickoff
+  const double n = double(trend.points.size());
+  double sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (const FloorPoint &p : trend.points) {
+    double x = double(p.timestampMs - end) / DAY_MS;
+    sx += x;
+    sy += p.floor;
+    sxx += x * x;
+    sxy += x * p.floor;
+  }
+  double denom = n * sxx - sx * sx;
+  if (denom > 1e-12)
+    trend.eurosPerDay = (n * sxy - sx * sy) / denom;
+  return trend;
+}
+
+QStringList PriceHistoryStore::sectors(QString *error) const {
+  QSet<QString> names;
+  scanHistory(m_path, error, [&names](const BlockView &b) {
+    for (quint32 i = 0; i < b.dictSize; ++i)
+      names.insert(b.name(i));
+  });
+  QStringList list(names.begin(), names.end());
+  list.removeAll(QString());
+  list.sort(Qt::CaseInsensitive);
+  return list;
+}
+
+int PriceHistoryStore::snapshotCount(QString *error) const {
+  int count = 0;
+  scanHistory(m_path, error, [&count](const BlockView &) { ++count; });
+  return count;
+}
+
+} // namespace GOL
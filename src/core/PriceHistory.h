@@ -0,0 +1,69 @@
+#ifndef PRICEHISTORY_H
+#define PRICEHISTORY_H
+
+#include "PriceEngine.h"
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace GOL {
+
+// Append-only, columnar history of parsed market pages, one file per event.
+//
+// File: "GOLPH1\0\0", then one block per page, 8-byte aligned, little endian:
+//   header   "SNAP", block bytes, timestamp (ms), rows, dictionary size,
+//            platform                                     (32 bytes)
+//   dict     quint32 offsets[size + 1], UTF-8 sector names (padded)
+//   columns  double price[rows], quint32 sector[rows], quint32 qty[rows],
+//            quint8 owned[rows]                            (padded)
+// Readers memory-map the file and stop at the first torn block; append()
+// cuts such a tail off before writing.
+class PriceHistoryStore {
+public:
+  explicit PriceHistoryStore(const QString &path) : m_path(path) {}
+
+  // AppData/price_history/<event>.golph
+  static QString pathForEvent(const QString &eventName);
+
+  QString path() const { return m_path; }
+
+  // Saves one page's records. A page already stored under the same
+  // timestamp and platform is skipped (returns true).
+  bool append(qint64 timestampMs, Platform platform,
+              const QList<PriceRecord> &records, QString *error = nullptr);
+
+  // Cheapest competitor of a sector in each stored page
+  struct FloorPoint {
+    qint64 timestampMs = 0;
+    Platform platform = Platform::UNKNOWN;
+    double floor = 0.0;
+    int competitors = 0;
+  };
+  // Oldest first; Platform::UNKNOWN means every platform
+  QList<FloorPoint> floorHistory(const QString &sector,
+                                 Platform platform = Platform::UNKNOWN,
+                                 QString *error = nullptr) const;
+
+  // How the floor moved over the last days before kickoff
+  struct FloorTrend {
+    QList<FloorPoint> points;
+    double firstFloor = 0.0;
+    double lastFloor = 0.0;
+    double eurosPerDay = 0.0; // Least-squares slope; negative = dropping
+  };
+  FloorTrend floorTrend(const QString &sector, const QDateTime &kickoff,
+                        int days = 14, Platform platform = Platform::UNKNOWN,
+                        QString *error = nullptr) const;
+
+  // Every sector with at least one stored row, sorted
+  QStringList sectors(QString *error = nullptr) const;
+  int snapshotCount(QString *error = nullptr) const;
+
+private:
+  QString m_path;
+};
+
+} // namespace GOL
+
+#endif // PRICEHISTORY_H
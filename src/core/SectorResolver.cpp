@@ -0,0 +1,272 @@
+#include "SectorResolver.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <climits>
+#include <utility>
+
+namespace GOL {
+
+static bool contains(const QString &str, const QString &sub) {
+  return str.contains(sub, Qt::CaseInsensitive);
+}
+
+// Word characters and boundaries as the old \bBLOCK\b regex saw them:
+// without UseUnicodePropertiesOption, \w is ASCII [A-Za-z0-9_] only
+static bool isWordAt(const QString &s, qsizetype i) {
+  if (i < 0 || i >= s.size())
+    return false;
+  char16_t c = s[i].unicode();
+  return (c >= u'a' && c <= u'z') || (c >= u'A' && c <= u'Z') ||
+         (c >= u'0' && c <= u'9') || c == u'_';
+}
+
+static bool isBoundary(const QString &s, qsizetype pos) {
+  return isWordAt(s, pos - 1) != isWordAt(s, pos);
+}
+
+bool SectorResolver::loadSectorDB(const QString &dbPath) {
+  QString path = dbPath;
+  if (path.isEmpty()) {
+    path = "resources/sector_db.json";
+    if (!QFile::exists(path)) {
+      path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+             "/sector_db.json";
+    }
+  }
+
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  for (auto it = root.begin(); it != root.end(); ++it) {
+    QString context = it.key().toLower();
+    QJsonObject sectors = it.value().toObject();
+    for (auto sit = sectors.begin(); sit != sectors.end(); ++sit) {
+      QString realSector = sit.key();
+      QJsonArray blocks = sit.value().toArray();
+      QStringList blockList;
+      for (const auto &v : blocks)
+        blockList << v.toString();
+      m_sectorDB[context][realSector] = blockList;
+    }
+  }
+  compileContext();
+  return true;
+}
+
+void SectorResolver::setContext(const QString &context) {
+  if (context == m_context && !m_nodes.isEmpty())
+    return;
+  m_context = context;
+  compileContext();
+}
+
+void SectorResolver::compileContext() {
+  m_cache.clear();
+  m_nodes = {MatchNode()};
+  m_rules.clear();
+  m_emptyRule = -1;
+
+  auto ctxIt = m_sectorDB.constFind(m_context);
+  if (m_context.isEmpty() || ctxIt == m_sectorDB.constEnd())
+    return;
+
+  // Trie of every block, numbered in the order they are tried
+  const QMap<QString, QStringList> &contextRules = ctxIt.value();
+  for (auto it = contextRules.begin(); it != contextRules.end(); ++it) {
+    for (const QString &b : it.value()) {
+      int id = int(m_rules.size());
+      m_rules.append({it.key(), b.size()});
+      if (b.isEmpty()) {
+        if (m_emptyRule < 0)
+          m_emptyRule = id;
+        continue;
+      }
+      int node = 0;
+      for (QChar c : b.toCaseFolded()) {
+        int child = m_nodes[node].next.value(c.unicode(), -1);
+        if (child < 0) {
+          child = int(m_nodes.size());
+          m_nodes[node].next.insert(c.unicode(), child);
+          m_nodes.append(MatchNode());
+        }
+        node = child;
+      }
+      m_nodes[node].rules.append(id);
+    }
+  }
+
+  // Failure links, breadth first so a node's fail target is already done
+  QList<int> queue;
+  for (int child : std::as_const(m_nodes[0].next))
+    queue.append(child);
+  for (qsizetype i = 0; i < queue.size(); ++i) {
+    const int node = queue[i];
+    const QHash<char16_t, int> next = m_nodes[node].next;
+    for (auto it = next.begin(); it != next.end(); ++it) {
+      int fail = m_nodes[node].fail;
+      while (fail > 0 && !m_nodes[fail].next.contains(it.key()))
+        fail = m_nodes[fail].fail;
+      fail = m_nodes[fail].next.value(it.key(), 0);
+      m_nodes[it.value()].fail = fail;
+      m_nodes[it.value()].rules += m_nodes[fail].rules;
+      queue.append(it.value());
+    }
+  }
+}
+
+int SectorResolver::matchContextRule(const QString &raw) const {
+  if (m_rules.isEmpty())
+    return -1;
+  int best = INT_MAX;
+  if (m_emptyRule >= 0) {
+    for (qsizetype p = 0; p <= raw.size(); ++p) {
+      if (isBoundary(raw, p)) {
+        best = m_emptyRule;
+        break;
+      }
+    }
+  }
+
+  // One pass over the name; a hit counts only with a boundary at both ends
+  const QString folded = raw.toCaseFolded();
+  int node = 0;
+  for (qsizetype i = 0; i < folded.size() && best > 0; ++i) {
+    const char16_t c = folded[i].unicode();
+    while (node > 0 && !m_nodes[node].next.contains(c))
+      node = m_nodes[node].fail;
+    node = m_nodes[node].next.value(c, 0);
+    for (int id : m_nodes[node].rules) {
+      if (id < best && isBoundary(raw, i + 1 - m_rules[id].length) &&
+          isBoundary(raw, i + 1))
+        best = id;
+    }
+  }
+  return best == INT_MAX ? -1 : best;
+}
+
+QString SectorResolver::detectStadiumContext(const QString &folderName) {
+  QString lower = folderName.toLower();
+  if (lower.contains("roma") || lower.contains("lazio"))
+    return "roma";
+  if (lower.contains("inter") || lower.contains("milan"))
+    return "inter";
+  if (lower.contains("fiorentina"))
+    return "fiorentina";
+  if (lower.contains("bologna"))
+    return "bologna";
+  if (lower.contains("atalanta"))
+    return "atalanta";
+  return "";
+}
+
+bool SectorResolver::resolve(const QString &raw, QString *canonical) const {
+  auto it = m_cache.constFind(raw);
+  if (it == m_cache.constEnd()) {
+    Resolution r;
+    r.known = true;
+    r.name = lookup(raw, &r.known);
+    it = m_cache.insert(raw, r);
+  }
+  if (canonical)
+    *canonical = it->name;
+  return it->known;
+}
+
+QString SectorResolver::canonicalName(const QString &raw) const {
+  QString name;
+  resolve(raw, &name);
+  return name;
+}
+
+QString SectorResolver::lookup(const QString &raw, bool *known) const {
+  QString norm = raw.toLower().trimmed();
+
+  // Clean "sector"
+  if (norm.startsWith("sector "))
+    norm = norm.mid(7).trimmed();
+
+  // --- SAN SIRO NUMERIC MAPPING (Primary Check) ---
+  if (m_context == "inter" || m_context == "milan") {
+    bool ok;
+    int n = norm.toInt(&ok);
+    if (ok) {
+      // RED (ROSSO)
+      if ((n >= 26 && n <= 36) || (n >= 170 && n <= 172))
+        return "PRIMO ROSSO";
+      if (n >= 221 && n <= 238)
+        return "SECONDO ROSSO";
+      if (n >= 319 && n <= 342)
+        return "TERZO ROSSO";
+
+      // BLUE (BLU)
+      if (n >= 101 && n <= 112)
+        return "PRIMO BLU";
+      if (n >= 201 && n <= 218)
+        return "SECONDO BLU";
+      if (n >= 301 && n <= 318)
+        return "TERZO BLU";
+
+      // GREEN (VERDE)
+      if (n >= 137 && n <= 148)
+        return "PRIMO VERDE";
+      if (n >= 239 && n <= 254)
+        return "SECONDO VERDE";
+      if (n >= 343 && n <= 360)
+        return "TERZO VERDE";
+
+      // ORANGE (ARANCIO)
+      if (n >= 149 && n <= 172)
+        return "PRIMO ARANCIO";
+      if (n >= 255 && n <= 276)
+        return "SECONDO ARANCIO";
+    }
+  }
+
+  // V18 Rule: EXTRA -> CURVA
+  if (norm == "extra")
+    return "CURVA";
+
+  int rule = matchContextRule(raw);
+  if (rule >= 0)
+    return canonicalName(m_rules[rule].sector);
+
+  if (contains(norm, "long side lower") ||
+      (contains(norm, "primo") && contains(norm, "rosso")) ||
+      (contains(norm, "primo") && contains(norm, "arancio")) ||
+      contains(norm, "1 tier central")) {
+    return "1st TIER CENTRAL";
+  }
+
+  if (contains(norm, "terzo rosso") || contains(norm, "terzo anello rosso") ||
+      contains(norm, "long side upper") || contains(norm, "long side") ||
+      contains(norm, "category 1") || contains(norm, "anello rosso")) {
+    return "TERZO ROSSO";
+  }
+
+  if (contains(norm, "curva") || contains(norm, "short side")) {
+    return "CURVA";
+  }
+
+  if (contains(norm, "distinti") || contains(norm, "corner area")) {
+    return "DISTINTI";
+  }
+
+  if ((contains(norm, "tevere") && contains(norm, "central")) ||
+      contains(norm, "tevere central stand")) {
+    return "TRIBUNA TEVERE CENTRAL";
+  }
+
+  if (contains(norm, "monte mario")) {
+    return "MONTE MARIO TOP STAND";
+  }
+
+  *known = false;
+  return raw.toUpper();
+}
+
+} // namespace GOL
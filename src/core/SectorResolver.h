@@ -0,0 +1,73 @@
+#ifndef SECTORRESOLVER_H
+#define SECTORRESOLVER_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+namespace GOL {
+
+// Maps raw folder / filename sector names onto canonical stadium sectors
+// using the built-in San Siro ranges and the rules from sector_db.json.
+class SectorResolver {
+public:
+  // Load "resources/sector_db.json" (or the AppData copy). Returns false if
+  // no database could be read.
+  bool loadSectorDB(const QString &path = QString());
+
+  static QString detectStadiumContext(const QString &folderName);
+
+  // Compiles the context's rules; clears the canonicalName cache
+  void setContext(const QString &context);
+  QString context() const { return m_context; }
+
+  // Context -> (Sector -> [Blocks])
+  const QMap<QString, QMap<QString, QStringList>> &sectorDB() const {
+    return m_sectorDB;
+  }
+
+  // Memoized per context. The cache makes const calls unsafe to share
+  // between threads: give each thread its own copy.
+  QString canonicalName(const QString &raw) const;
+  // Same, and whether a mapping or rule recognized raw; false means
+  // *canonical is just raw upper-cased (which a canonical name can also be)
+  bool resolve(const QString &raw, QString *canonical = nullptr) const;
+
+private:
+  // Aho-Corasick automaton over the case-folded blocks of the context
+  struct MatchNode {
+    QHash<char16_t, int> next;
+    int fail = 0;
+    QList<int> rules; // Blocks ending here, fail-link matches included
+  };
+  struct BlockRule {
+    QString sector;
+    qsizetype length = 0;
+  };
+
+  struct Resolution {
+    QString name;
+    bool known = false;
+  };
+
+  void compileContext();
+  // canonicalName without the cache; clears *known on the fallback
+  QString lookup(const QString &raw, bool *known) const;
+  // First rule, in sector_db order, whose block occurs in raw as a whole
+  // word (like \bBLOCK\b); -1 if none
+  int matchContextRule(const QString &raw) const;
+
+  QMap<QString, QMap<QString, QStringList>> m_sectorDB;
+  QString m_context;
+
+  QList<MatchNode> m_nodes;
+  QList<BlockRule> m_rules; // Index = priority, lowest wins
+  int m_emptyRule = -1;     // An empty block matches at any word boundary
+  mutable QHash<QString, Resolution> m_cache;
+};
+
+} // namespace GOL
+
+#endif // SECTORRESOLVER_H
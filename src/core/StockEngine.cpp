@@ -0,0 +1,260 @@
+#include "StockEngine.h"
+#include "TicketTokenizer.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+
+namespace GOL {
+
+const QString StockEngine::ERROR_NO_TICKETS_FOLDER = "ERROR_NO_TICKETS_FOLDER";
+
+std::tuple<QString, QString, QString>
+StockEngine::extractSrsFromFilename(const QString &filename) {
+  TicketTokenizer::Tokens t = TicketTokenizer::tokenize(filename);
+  if (!t.isValid())
+    return {};
+  return {t.sector.toString().toUpper(), t.row.toString(), t.seat.toString()};
+}
+
+QString StockEngine::extractFvFromFilename(const QString &filename) {
+  return TicketTokenizer::formatFaceValue(
+      TicketTokenizer::tokenize(filename).faceValue);
+}
+
+std::pair<int, QString> StockEngine::parseSeatDetailed(const QString &seatStr) {
+  TicketTokenizer::Seat seat = TicketTokenizer::parseSeat(seatStr);
+  if (!seat.hasNumber)
+    return {0, seatStr};
+  return {seat.num, seat.suffixString()};
+}
+
+void StockEngine::sortSeatKeys(QList<quint64> &keys) {
+  const qsizetype n = keys.size();
+  if (n < 64) {
+    std::sort(keys.begin(), keys.end()); // Radix setup costs more here
+    return;
+  }
+
+  // LSD radix sort on bytes, skipping bytes that are equal in every key
+  // (one suffix per row and seat numbers < 65536 leave two passes).
+  quint64 anyBits = 0;
+  quint64 allBits = ~quint64(0);
+  for (quint64 k : keys) {
+    anyBits |= k;
+    allBits &= k;
+  }
+  const quint64 varying = anyBits ^ allBits;
+
+  QList<quint64> buffer(n);
+  quint64 *src = keys.data();
+  quint64 *dst = buffer.data();
+  for (int shift = 0; shift < 64; shift += 8) {
+    if (((varying >> shift) & 0xFF) == 0)
+      continue;
+
+    qsizetype offsets[256] = {};
+    for (qsizetype i = 0; i < n; ++i)
+      ++offsets[(src[i] >> shift) & 0xFF];
+    qsizetype sum = 0;
+    for (qsizetype &o : offsets) {
+      qsizetype count = o;
+      o = sum;
+      sum += count;
+    }
+    for (qsizetype i = 0; i < n; ++i)
+      dst[offsets[(src[i] >> shift) & 0xFF]++] = src[i];
+    std::swap(src, dst);
+  }
+  if (src != keys.data())
+    std::copy(src, src + n, keys.data());
+}
+
+QList<StockEngine::SeatRun>
+StockEngine::findConsecutiveRuns(const QList<quint64> &sortedKeys, int step) {
+  QList<SeatRun> runs;
+  const qsizetype n = sortedKeys.size();
+  if (n == 0)
+    return runs;
+
+  qsizetype begin = 0;
+  for (qsizetype i = 1; i < n; ++i) {
+    // Same suffix (high half) and number exactly step above the previous
+    if (sortedKeys[i] != sortedKeys[i - 1] + quint64(step) ||
+        (sortedKeys[i] >> 32) != (sortedKeys[i - 1] >> 32)) {
+      runs.append({begin, i});
+      begin = i;
+    }
+  }
+  runs.append({begin, n});
+  return runs;
+}
+
+QMap<QString, StockModel::Sector>
+StockEngine::buildSectors(const QStringList &pdfs, bool oddEvenMode,
+                           const QSet<QString> &onlySectors) {
+  int step = oddEvenMode ? 2 : 1;
+
+  // Seats of one row: suffixes are interned, seats are packed keys
+  struct RowSeats {
+    QStringList suffixes; // By id, first-seen order
+    QHash<QString, quint32> suffixIds;
+    QList<quint64> keys;
+  };
+
+  // Organize by Sector -> Row -> Seats
+  QMap<QString, QMap<QString, RowSeats>> data;
+  QMap<QString, QString> priceMap; // Key: "Sec|Row"
+
+  for (const QString &f : pdfs) {
+    TicketTokenizer::Tokens t = TicketTokenizer::tokenize(f);
+    if (!t.isValid())
+      continue;
+
+    QString sec = t.sector.toString().toUpper();
+    if (!onlySectors.isEmpty() && !onlySectors.contains(sec))
+      continue;
+    QString row = t.row.toString();
+
+    // A seat without digits sorts as number 0 with the whole text as suffix
+    TicketTokenizer::Seat seat = TicketTokenizer::parseSeat(t.seat);
+    QString suffix = seat.hasNumber ? seat.suffixString() : t.seat.toString();
+
+    RowSeats &rs = data[sec][row];
+    auto id = rs.suffixIds.constFind(suffix);
+    if (id == rs.suffixIds.constEnd()) {
+      id = rs.suffixIds.insert(suffix, quint32(rs.suffixes.size()));
+      rs.suffixes.append(suffix);
+    }
+    rs.keys.append(packSeat(id.value(), quint32(seat.num)));
+
+    QString key = sec + "|" + row;
+    if (!priceMap.contains(key)) {
+      priceMap[key] = TicketTokenizer::formatFaceValue(t.faceValue);
+    }
+  }
+
+  QMap<QString, StockModel::Sector> sectors;
+  for (auto itSec = data.begin(); itSec != data.end(); ++itSec) {
+    StockModel::Sector &sector = sectors[itSec.key()];
+    sector.name = itSec.key();
+
+    // Sort rows naturally
+    QStringList rows = itSec.value().keys();
+    std::sort(rows.begin(), rows.end(),
+              [](const QString &a, const QString &b) {
+                // Try number sort if possible
+                bool ok1, ok2;
+                int n1 = a.toInt(&ok1);
+                int n2 = b.toInt(&ok2);
+                if (ok1 && ok2)
+                  return n1 < n2;
+                return a < b;
+              });
+
+    for (const QString &row : rows) {
+      RowSeats &rs = itSec.value()[row];
+
+      // Re-number suffix ids by string order so keys sort suffix-first
+      QStringList sortedSuffixes = rs.suffixes;
+      if (sortedSuffixes.size() > 1) {
+        std::sort(sortedSuffixes.begin(), sortedSuffixes.end());
+        QList<quint64> rank(rs.suffixes.size());
+        for (qsizetype i = 0; i < sortedSuffixes.size(); ++i)
+          rank[rs.suffixIds.value(sortedSuffixes[i])] = quint64(i) << 32;
+        for (quint64 &k : rs.keys)
+          k = rank[qsizetype(k >> 32)] | (k & 0xFFFFFFFFu);
+      }
+      sortSeatKeys(rs.keys);
+
+      auto raw = [&](quint64 k) {
+        qsizetype suffix = qsizetype(k >> 32);
+        return QString::number(k & 0xFFFFFFFFu) + sortedSuffixes[suffix];
+      };
+
+      StockModel::Row modelRow;
+      modelRow.name = row;
+      modelRow.price = priceMap.value(itSec.key() + "|" + row, "N/A");
+      for (const SeatRun &run : findConsecutiveRuns(rs.keys, step)) {
+        modelRow.groups.append({raw(rs.keys[run.begin]),
+                                raw(rs.keys[run.end - 1]),
+                                int(run.end - run.begin)});
+      }
+      sector.rows.append(modelRow);
+    }
+  }
+  return sectors;
+}
+
+StockModel::Category StockEngine::buildCategory(const QString &name,
+                                                const QString &path,
+                                                bool oddEvenMode) {
+  StockModel::Category category;
+  category.name = name;
+  QStringList pdfs =
+      QDir(path).entryList(QStringList() << "*.pdf", QDir::Files);
+  category.total = pdfs.size();
+  if (!pdfs.isEmpty())
+    category.sectors = buildSectors(pdfs, oddEvenMode);
+  return category;
+}
+
+QList<StockEngine::Category>
+StockEngine::listCategories(const QString &ticketsPath) {
+  // Loose PDFs in - Tickets - root first, then every subfolder by name
+  QList<Category> categories;
+  categories.append({"- Extra without folder -", ticketsPath});
+  QDir ticketsDir(ticketsPath);
+  for (const QString &d :
+       ticketsDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+    categories.append({d, ticketsPath + "/" + d});
+  }
+  return categories;
+}
+
+StockModel::Event StockEngine::buildModel(const QString &basePath,
+                                          bool oddEvenMode, bool parallel) {
+  StockModel::Event event;
+  event.name = QFileInfo(basePath).fileName();
+  event.path = basePath;
+  event.generatedAt = QDateTime::currentDateTime();
+
+  QString ticketsPath = basePath + "/- Tickets -";
+  if (basePath.isEmpty() || !QDir(ticketsPath).exists()) {
+    event.error = ERROR_NO_TICKETS_FOLDER;
+    return event;
+  }
+
+  QList<Category> categories = listCategories(ticketsPath);
+  auto build = [oddEvenMode](const Category &c) {
+    return buildCategory(c.name, c.path, oddEvenMode);
+  };
+  if (parallel) {
+    // blockingMapped keeps input order, so the report stays deterministic
+    event.categories =
+        QtConcurrent::blockingMapped<QList<StockModel::Category>>(categories,
+                                                                  build);
+  } else {
+    for (const Category &c : categories)
+      event.categories.append(build(c));
+  }
+  return event;
+}
+
+QString StockEngine::generateReportContent(const QString &basePath,
+                                           bool oddEvenMode, bool parallel) {
+  if (basePath.isEmpty())
+    return "";
+
+  StockModel::Event event = buildModel(basePath, oddEvenMode, parallel);
+  if (!event.error.isEmpty())
+    return event.error;
+  return StockModel::render(event);
+}
+
+} // namespace GOL
@@ -0,0 +1,76 @@
+#ifndef STOCKENGINE_H
+#define STOCKENGINE_H
+
+#include "StockModel.h"
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <tuple>
+#include <utility>
+
+namespace GOL {
+
+// Headless stock calculation shared by CalcStock and CheckListing.
+// Everything here is widget-free and safe to call from worker threads.
+class StockEngine {
+public:
+  // Sorted seats [begin, end) that form one consecutive group
+  struct SeatRun {
+    qsizetype begin;
+    qsizetype end;
+  };
+
+  // A "- Tickets -" category: the loose PDFs or one subfolder
+  struct Category {
+    QString name;
+    QString path;
+  };
+
+  // Returned by generateReportContent when the event has no ticket folder
+  static const QString ERROR_NO_TICKETS_FOLDER;
+
+  // Filename helpers ("SEC-ROW-SEAT-FV12p50.pdf")
+  static std::tuple<QString, QString, QString>
+  extractSrsFromFilename(const QString &filename);
+  static QString extractFvFromFilename(const QString &filename);
+  static std::pair<int, QString> parseSeatDetailed(const QString &seatStr);
+
+  // A seat of one row as (suffix rank << 32) | number, so that ordering the
+  // keys orders by suffix, then number
+  static quint64 packSeat(quint32 suffixRank, quint32 num) {
+    return (quint64(suffixRank) << 32) | num;
+  }
+  static void sortSeatKeys(QList<quint64> &keys);
+  // Runs of equal suffix whose numbers go up by step (2 in odd-even mode)
+  static QList<SeatRun> findConsecutiveRuns(const QList<quint64> &sortedKeys,
+                                            int step);
+
+  // Group the PDFs of one category into sectors, rows and seat groups.
+  // With onlySectors set, every other sector is skipped.
+  static QMap<QString, StockModel::Sector>
+  buildSectors(const QStringList &pdfs, bool oddEvenMode,
+               const QSet<QString> &onlySectors = QSet<QString>());
+
+  // List, parse and group the PDFs of one category folder
+  static StockModel::Category buildCategory(const QString &name,
+                                            const QString &path,
+                                            bool oddEvenMode);
+
+  static QList<Category> listCategories(const QString &ticketsPath);
+
+  // Scan "<basePath>/- Tickets -" into a typed model. With parallel set,
+  // categories are built on the global thread pool; the result is the same
+  // either way. error is ERROR_NO_TICKETS_FOLDER if there is nothing to scan.
+  static StockModel::Event buildModel(const QString &basePath,
+                                      bool oddEvenMode, bool parallel = true);
+
+  // Text stock report of buildModel (or the error sentinel)
+  static QString generateReportContent(const QString &basePath,
+                                       bool oddEvenMode, bool parallel = true);
+};
+
+} // namespace GOL
+
+#endif // STOCKENGINE_H
@@ -0,0 +1,241 @@
+#include "StockManifest.h"
+#include "TicketTokenizer.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrent>
+
+namespace GOL {
+
+static const int MANIFEST_VERSION = 2; // 2: typed sector model
+
+static qint64 folderMtime(const QString &path) {
+  return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+}
+
+static QStringList stringsFromJson(const QJsonValue &value) {
+  QStringList list;
+  for (const auto &v : value.toArray())
+    list << v.toString();
+  return list;
+}
+
+StockManifest::StockManifest(const QString &basePath, bool oddEvenMode)
+    : m_basePath(basePath), m_oddEvenMode(oddEvenMode) {}
+
+QString StockManifest::defaultCachePath(const QString &basePath,
+                                        bool oddEvenMode) {
+  QString key = QDir::cleanPath(QFileInfo(basePath).absoluteFilePath()) +
+                (oddEvenMode ? "|oddeven" : "|seq");
+  QString hash =
+      QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+         "/stock_manifests/" + hash + ".json";
+}
+
+bool StockManifest::load(const QString &cachePath) {
+  QString path = cachePath.isEmpty()
+                     ? defaultCachePath(m_basePath, m_oddEvenMode)
+                     : cachePath;
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  if (root.value("version").toInt() != MANIFEST_VERSION ||
+      root.value("event").toString() != m_basePath ||
+      root.value("oddEven").toBool() != m_oddEvenMode)
+    return false;
+
+  m_entries.clear();
+  QJsonObject categories = root.value("categories").toObject();
+  for (auto it = categories.begin(); it != categories.end(); ++it) {
+    QJsonObject c = it.value().toObject();
+    Entry e;
+    e.mtime = c.value("mtime").toInteger(-1);
+    e.files = stringsFromJson(c.value("files"));
+    e.category.name = it.key();
+    e.category.total = e.files.size();
+    QJsonObject sectors = c.value("sectors").toObject();
+    for (auto sit = sectors.begin(); sit != sectors.end(); ++sit) {
+      e.category.sectors[sit.key()] =
+          StockModel::sectorFromJson(sit.key(), sit.value().toObject());
+    }
+    m_entries.insert(it.key(), e);
+  }
+  return true;
+}
+
+bool StockManifest::save(const QString &cachePath) const {
+  QString path = cachePath.isEmpty()
+                     ? defaultCachePath(m_basePath, m_oddEvenMode)
+                     : cachePath;
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QJsonObject categories;
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+    QJsonObject sectors;
+    const auto &catSectors = it.value().category.sectors;
+    for (auto sit = catSectors.begin(); sit != catSectors.end(); ++sit)
+      sectors[sit.key()] = StockModel::toJson(sit.value());
+
+    QJsonObject c;
+    c["mtime"] = it.value().mtime;
+    c["files"] = QJsonArray::fromStringList(it.value().files);
+    c["sectors"] = sectors;
+    categories[it.key()] = c;
+  }
+
+  QJsonObject root;
+  root["version"] = MANIFEST_VERSION;
+  root["event"] = m_basePath;
+  root["oddEven"] = m_oddEvenMode;
+  root["categories"] = categories;
+
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+  return file.commit();
+}
+
+StockManifest::Entry
+StockManifest::rescan(const StockEngine::Category &category,
+                      const Entry &previous, bool oddEvenMode) {
+  Entry e;
+  e.mtime = folderMtime(category.path);
+  e.files =
+      QDir(category.path).entryList(QStringList() << "*.pdf", QDir::Files);
+  e.category.name = category.name;
+  e.category.total = e.files.size();
+
+  if (previous.mtime < 0) {
+    e.category.sectors = StockEngine::buildSectors(e.files, oddEvenMode);
+    return e;
+  }
+
+  // Only sectors that gained or lost a PDF need grouping again
+  QSet<QString> oldFiles(previous.files.begin(), previous.files.end());
+  QSet<QString> newFiles(e.files.begin(), e.files.end());
+  QSet<QString> touched;
+  for (const QString &f : (newFiles - oldFiles) + (oldFiles - newFiles)) {
+    TicketTokenizer::Tokens t = TicketTokenizer::tokenize(f);
+    if (t.isValid())
+      touched.insert(t.sector.toString().toUpper());
+  }
+
+  e.category.sectors = previous.category.sectors;
+  if (!touched.isEmpty()) {
+    for (const QString &sec : touched)
+      e.category.sectors.remove(sec);
+    auto rebuilt = StockEngine::buildSectors(e.files, oddEvenMode, touched);
+    for (auto it = rebuilt.begin(); it != rebuilt.end(); ++it)
+      e.category.sectors.insert(it.key(), it.value());
+  }
+  return e;
+}
+
+QString StockManifest::refresh(bool parallel) {
+  if (m_basePath.isEmpty()) {
+    m_rescanned = 0;
+    return "";
+  }
+  StockModel::Event event = refreshModel(parallel);
+  return event.error.isEmpty() ? StockModel::render(event) : event.error;
+}
+
+StockModel::Event StockManifest::refreshModel(bool parallel) {
+  m_rescanned = 0;
+  StockModel::Event event;
+  event.name = QFileInfo(m_basePath).fileName();
+  event.path = m_basePath;
+  event.generatedAt = QDateTime::currentDateTime();
+
+  QString ticketsPath = m_basePath + "/- Tickets -";
+  if (m_basePath.isEmpty() || !QDir(ticketsPath).exists()) {
+    m_entries.clear();
+    event.error = StockEngine::ERROR_NO_TICKETS_FOLDER;
+    return event;
+  }
+
+  QList<StockEngine::Category> categories =
+      StockEngine::listCategories(ticketsPath);
+
+  // Folders whose mtime moved (or that are new) are re-read
+  struct Job {
+    StockEngine::Category category;
+    Entry previous;
+  };
+  QList<Job> jobs;
+  for (const auto &c : categories) {
+    auto it = m_entries.constFind(c.name);
+    if (it == m_entries.constEnd() || m_forced.contains(c.name) ||
+        it->mtime != folderMtime(c.path))
+      jobs.append({c, it == m_entries.constEnd() ? Entry() : it.value()});
+  }
+  m_forced.clear();
+
+  bool oddEven = m_oddEvenMode;
+  auto run = [oddEven](const Job &job) {
+    return rescan(job.category, job.previous, oddEven);
+  };
+  QList<Entry> fresh;
+  if (parallel) {
+    fresh = QtConcurrent::blockingMapped<QList<Entry>>(jobs, run);
+  } else {
+    for (const Job &job : jobs)
+      fresh.append(run(job));
+  }
+  m_rescanned = jobs.size();
+
+  // Rebuild the cache from the current listing, so deleted folders drop out
+  QHash<QString, Entry> entries;
+  for (int i = 0; i < jobs.size(); ++i)
+    entries.insert(jobs[i].category.name, fresh[i]);
+
+  for (const auto &c : categories) {
+    if (!entries.contains(c.name))
+      entries.insert(c.name, m_entries.value(c.name));
+    event.categories.append(entries.value(c.name).category);
+  }
+  m_entries = entries;
+  return event;
+}
+
+void StockManifest::markChanged(const QString &folderPath) {
+  QString ticketsPath = QDir::cleanPath(m_basePath + "/- Tickets -");
+  QString path = QDir::cleanPath(folderPath);
+  if (path == ticketsPath) {
+    m_forced.insert(StockEngine::listCategories(ticketsPath).first().name);
+  } else if (QFileInfo(path).absolutePath() == ticketsPath) {
+    m_forced.insert(QFileInfo(path).fileName());
+  }
+}
+
+StockModel::Event StockManifest::generateModel(const QString &basePath,
+                                              bool oddEvenMode) {
+  StockManifest manifest(basePath, oddEvenMode);
+  manifest.load();
+  StockModel::Event event = manifest.refreshModel();
+  if (event.error.isEmpty())
+    manifest.save();
+  return event;
+}
+
+QString StockManifest::generateReport(const QString &basePath,
+                                      bool oddEvenMode) {
+  if (basePath.isEmpty())
+    return "";
+  StockModel::Event event = generateModel(basePath, oddEvenMode);
+  return event.error.isEmpty() ? StockModel::render(event) : event.error;
+}
+
+} // namespace GOL
@@ -0,0 +1,68 @@
+#ifndef STOCKMANIFEST_H
+#define STOCKMANIFEST_H
+
+#include "StockEngine.h"
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+namespace GOL {
+
+// Incremental CalcStock: remembers, per "- Tickets -" category, the folder
+// mtime, its PDF names and the grouped sectors. refresh() re-reads
+// only folders whose mtime changed and re-groups only the sectors whose
+// files were added or removed. The cache is a JSON file in AppData.
+class StockManifest {
+public:
+  StockManifest(const QString &basePath, bool oddEvenMode);
+
+  // AppData/stock_manifests/<hash of path and mode>.json
+  static QString defaultCachePath(const QString &basePath, bool oddEvenMode);
+
+  // Loads a cache written for the same event and mode. A missing or stale
+  // file just means the next refresh() scans everything.
+  bool load(const QString &cachePath = QString());
+  bool save(const QString &cachePath = QString()) const;
+
+  // Same model as StockEngine::buildModel
+  StockModel::Event refreshModel(bool parallel = true);
+  // Same text as StockEngine::generateReportContent
+  QString refresh(bool parallel = true);
+
+  // Force the next refresh() to re-read a folder even if its mtime did not
+  // move (coarse mtimes on network shares). Accepts "- Tickets -" itself
+  // or one of its subfolders.
+  void markChanged(const QString &folderPath);
+
+  QString basePath() const { return m_basePath; }
+  bool oddEvenMode() const { return m_oddEvenMode; }
+
+  // Folders re-read by the last refresh() (0 when nothing changed)
+  int rescannedCategories() const { return m_rescanned; }
+
+  // load() + refresh() + save(), for one-shot callers
+  static StockModel::Event generateModel(const QString &basePath,
+                                         bool oddEvenMode);
+  static QString generateReport(const QString &basePath, bool oddEvenMode);
+
+private:
+  struct Entry {
+    qint64 mtime = -1;
+    QStringList files;
+    StockModel::Category category;
+  };
+
+  static Entry rescan(const StockEngine::Category &category,
+                      const Entry &previous, bool oddEvenMode);
+
+  QString m_basePath;
+  bool m_oddEvenMode;
+  QHash<QString, Entry> m_entries; // Category name -> cached state
+  QSet<QString> m_forced;          // Category names to re-read
+  int m_rescanned = 0;
+};
+
+} // namespace GOL
+
+#endif // STOCKMANIFEST_H
@@ -0,0 +1,115 @@
+#include "StockModel.h"
+#include <QJsonArray>
+
+namespace GOL {
+
+int StockModel::Sector::total() const {
+  int sum = 0;
+  for (const Row &row : rows)
+    for (const SeatGroup &g : row.groups)
+      sum += g.qty;
+  return sum;
+}
+
+int StockModel::Event::grandTotal() const {
+  int sum = 0;
+  for (const Category &c : categories)
+    sum += c.total;
+  return sum;
+}
+
+QStringList StockModel::renderLines(const Event &event, QList<Slot> *slots) {
+  QStringList lines;
+  lines << QString("⚽ EVENT: %1").arg(event.name);
+  lines << QString("📅 DATE: %1")
+               .arg(event.generatedAt.toString("yyyy-MM-dd HH:mm"));
+  lines << QString("🥅 GRAND TOTAL: %1").arg(event.grandTotal());
+  lines << "========================================";
+  lines << "";
+
+  int bodyStart = lines.size();
+  for (const Category &category : event.categories) {
+    if (category.total == 0)
+      continue; // Empty folders are not listed
+    lines.append(QString("📂 %1").arg(category.name));
+    lines.append(QString("🥅 TOTAL: %1").arg(category.total));
+
+    for (const Sector &sector : category.sectors) {
+      QStringList secCounts;
+      for (const Row &row : sector.rows)
+        for (const SeatGroup &g : row.groups)
+          secCounts.append(QString::number(g.qty));
+      lines.append(QString("🎫 Sector: %1 Total: %2 | %3")
+                       .arg(sector.name)
+                       .arg(sector.total())
+                       .arg(secCounts.join("+")));
+
+      for (const Row &row : sector.rows) {
+        for (const SeatGroup &g : row.groups) {
+          QString range =
+              g.qty > 1 ? QString("%1/%2").arg(g.first, g.last) : g.first;
+          QString prefix = QString("💺Row: %1 Seat: %2 Qty: %3 ")
+                               .arg(row.name, range)
+                               .arg(g.qty);
+          if (slots)
+            slots->append({sector.name, g.qty, int(lines.size()), prefix});
+          lines.append(QString("%1[%2]").arg(prefix, row.price));
+        }
+      }
+    }
+    lines.append(""); // Empty line
+  }
+  if (lines.size() == bodyStart)
+    lines.append(""); // Header + "\n" + empty body
+
+  return lines;
+}
+
+QString StockModel::render(const Event &event) {
+  return renderLines(event).join("\n");
+}
+
+QStringList StockModel::sectorNames(const Event &event) {
+  QStringList names;
+  for (const Category &category : event.categories) {
+    if (category.total == 0)
+      continue;
+    for (const Sector &sector : category.sectors)
+      names.append(sector.name);
+  }
+  names.removeDuplicates();
+  return names;
+}
+
+QJsonObject StockModel::toJson(const Sector &sector) {
+  QJsonArray rows;
+  for (const Row &row : sector.rows) {
+    QJsonArray groups;
+    for (const SeatGroup &g : row.groups)
+      groups.append(QJsonArray{g.first, g.last, g.qty});
+    rows.append(QJsonObject{
+        {"name", row.name}, {"price", row.price}, {"groups", groups}});
+  }
+  return QJsonObject{{"rows", rows}};
+}
+
+StockModel::Sector StockModel::sectorFromJson(const QString &name,
+                                              const QJsonObject &json) {
+  Sector sector;
+  sector.name = name;
+  for (const auto &r : json.value("rows").toArray()) {
+    QJsonObject obj = r.toObject();
+    Row row;
+    row.name = obj.value("name").toString();
+    row.price = obj.value("price").toString();
+    for (const auto &g : obj.value("groups").toArray()) {
+      QJsonArray a = g.toArray();
+      row.groups.append(
+          {a.at(0).toString(), a.at(1).toString(), a.at(2).toInt()});
+    }
+    sector.rows.append(row);
+  }
+  return sector;
+}
+
+} // namespace GOL
@@ -0,0 +1,77 @@
+#ifndef STOCKMODEL_H
+#define STOCKMODEL_H
+
+#include <QDateTime>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+namespace GOL {
+
+// Typed result of a CalcStock scan: event -> categories -> sectors -> rows
+// -> consecutive seat groups. The text report is rendered from it, and
+// CheckListing allocates on it directly instead of parsing the text back.
+class StockModel {
+public:
+  struct SeatGroup {
+    QString first; // Seat labels as printed ("12", "14A")
+    QString last;
+    int qty = 0;
+  };
+
+  struct Row {
+    QString name;
+    QString price; // "45.50€" or "N/A"
+    QList<SeatGroup> groups;
+  };
+
+  struct Sector {
+    QString name; // Upper case
+    QList<Row> rows;
+
+    int total() const;
+  };
+
+  // "- Extra without folder -" or a "- Tickets -" subfolder
+  struct Category {
+    QString name;
+    int total = 0;                 // PDFs in the folder, 0 if none
+    QMap<QString, Sector> sectors; // By name
+  };
+
+  struct Event {
+    QString name;
+    QString path;
+    QDateTime generatedAt;
+    QList<Category> categories;
+    QString error; // StockEngine::ERROR_NO_TICKETS_FOLDER, empty if ok
+
+    int grandTotal() const;
+  };
+
+  // A "💺Row:" line of the rendered report, where allocations go
+  struct Slot {
+    QString sector;
+    int qty = 0;
+    int line = 0;   // Index into the rendered lines
+    QString prefix; // Line text before "[price]"
+  };
+
+  // Report lines; join("\n") gives exactly render(event)
+  static QStringList renderLines(const Event &event,
+                                 QList<Slot> *slots = nullptr);
+  static QString render(const Event &event);
+
+  // Sector names in report order, without duplicates
+  static QStringList sectorNames(const Event &event);
+
+  // Manifest cache serialisation of one sector
+  static QJsonObject toJson(const Sector &sector);
+  static Sector sectorFromJson(const QString &name, const QJsonObject &json);
+};
+
+} // namespace GOL
+
+#endif // STOCKMODEL_H
@@ -0,0 +1,478 @@
+#include "StockReportEngine.h"
+#include "TicketTokenizer.h"
+#include <QDate>
+#include <QDirIterator>
+#include <QRegularExpression>
+
+namespace GOL {
+
+static bool contains(const QString &str, const QString &sub) {
+  return str.contains(sub, Qt::CaseInsensitive);
+}
+
+// Upper-cased sector of a stock PDF name, empty if it has no SEC-ROW-SEAT
+static QString sectorOf(const QString &fileName) {
+  TicketTokenizer::Tokens t = TicketTokenizer::tokenize(fileName);
+  return t.isValid() ? t.sector.toString().toUpper() : QString();
+}
+
+QString StockReportEngine::classifyPlatform(const QString &folderName) {
+  QString lower = folderName.toLower();
+  if (lower.contains("gogo"))
+    return "Gogo";
+  if (lower.contains("viagogo"))
+    return "Gogo";
+  if (lower.contains("stubhub"))
+    return "StubHub";
+  if (lower.contains("ticombo"))
+    return "Ticombo";
+  if (lower.contains("tixstock"))
+    return "Tixstock";
+  if (lower.contains("net"))
+    return "Net";
+  if (lower.contains("sport"))
+    return "SportsEvents";
+
+  // FALLBACK: Regex ID Detection
+  // Gogo: 9-10 digits (e.g. 626946288)
+  if (folderName.contains(QRegularExpression("\\b\\d{9,10}\\b")))
+    return "Gogo";
+  // Tixstock: 8 char hex (e.g. BBC7F522) - avoiding simple words
+  if (folderName.contains(QRegularExpression("\\b[A-F0-9]{8}\\b")))
+    return "Tixstock";
+  // Net: 7 digits (e.g. 1539879)
+  if (folderName.contains(QRegularExpression("\\b\\d{7}\\b")))
+    return "Net";
+
+  return "Private/Other";
+}
+
+int StockReportEngine::countPdfs(const QString &path) {
+  int count = 0;
+  QDirIterator it(path, QStringList() << "*.pdf", QDir::Files,
+                  QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    count++;
+  }
+  return count;
+}
+
+QPair<QString, int>
+StockReportEngine::parseSectorAndQuantity(const QString &folderName,
+                                          const QString &fullPath) {
+  // 1. Quantity
+  int qty = 0;
+  QRegularExpression qtyRe("x\\s*(\\d+)",
+                           QRegularExpression::CaseInsensitiveOption);
+  QRegularExpressionMatch qtyMatch = qtyRe.match(folderName);
+
+  if (qtyMatch.hasMatch()) {
+    qty = qtyMatch.captured(1).toInt();
+  } else if (!fullPath.isEmpty()) {
+    qty = countPdfs(fullPath);
+  }
+
+  if (qty == 0)
+    qty = 1;
+
+  // 2. Sector Extraction
+  QString sector = folderName;
+
+  // Priority to IDs: match parts BEFORE the ID
+  QRegularExpression gogoRe("^(.*?)\\s+\\d{9}");
+  QRegularExpression netRe("^(.*?)\\s+\\d{7}");
+  QRegularExpression tixRe("^(.*?)\\s+[A-F0-9]{8}\\b",
+                           QRegularExpression::CaseInsensitiveOption);
+
+  QRegularExpressionMatch m;
+
+  if ((m = gogoRe.match(folderName)).hasMatch()) {
+    sector = m.captured(1);
+  } else if ((m = netRe.match(folderName)).hasMatch()) {
+    sector = m.captured(1);
+  } else if ((m = tixRe.match(folderName)).hasMatch()) {
+    sector = m.captured(1);
+  } else {
+    // Fallback: part before "xN"
+    if (qtyMatch.hasMatch()) {
+      int idx = qtyMatch.capturedStart();
+      if (idx > 0) {
+        sector = folderName.left(idx);
+      }
+    }
+  }
+
+  // Handle "Inside X": if folder says "inside 236", real sector is 236
+  QRegularExpression insideRe("inside\\s+([A-Za-z0-9\\s]+)",
+                              QRegularExpression::CaseInsensitiveOption);
+  QRegularExpressionMatch insideM = insideRe.match(folderName);
+  if (insideM.hasMatch()) {
+    sector = insideM.captured(1);
+  }
+
+  // Cleanup
+  sector = sector.trimmed();
+  sector.remove(QRegularExpression("Gogo|Net|Tixstock|StubHub|Ticombo",
+                                   QRegularExpression::CaseInsensitiveOption));
+  sector.remove(QRegularExpression("BOUGHT.*|need info",
+                                   QRegularExpression::CaseInsensitiveOption));
+
+  if (sector.endsWith(" ID-", Qt::CaseInsensitive)) {
+    sector.chop(4);
+  }
+  sector = sector.trimmed();
+  while (sector.endsWith("-"))
+    sector.chop(1);
+  while (sector.startsWith("-"))
+    sector = sector.mid(1);
+
+  return qMakePair(sector.trimmed(), qty);
+}
+
+QString StockReportEngine::findDeliveredFolder(const QDir &rootDir) {
+  return findDeliveredFolder(
+      rootDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot));
+}
+
+QString StockReportEngine::findDeliveredFolder(const QStringList &dirNames) {
+  QStringList candidates = {"caricati", "carricati", "caricatti", "sent",
+                            "delivered"};
+  for (const QString &d : dirNames) {
+    for (const QString &cand : candidates) {
+      if (d.contains(cand, Qt::CaseInsensitive))
+        return d;
+    }
+  }
+  return "";
+}
+
+QString StockReportEngine::eventTitleForPath(const QString &rootPath) {
+  // Robust Title Extraction: Walk up until we find a non-generic name
+  QDir rDir(rootPath);
+  QString folderTitle = rDir.dirName();
+
+  while (folderTitle.contains("tickets", Qt::CaseInsensitive) ||
+         folderTitle.contains("stock", Qt::CaseInsensitive) ||
+         folderTitle.startsWith("-")) {
+    if (!rDir.cdUp())
+      break; // Stop if root
+    folderTitle = rDir.dirName();
+  }
+  return folderTitle;
+}
+
+// ---------------------------------------------------------
+// ANALYSIS (V19 Logic: Regex Update + Extra Fix)
+// ---------------------------------------------------------
+
+StockReportEngine::Result
+StockReportEngine::analyze(const QString &rootPath, SectorResolver &resolver) {
+  return analyze(EventSnapshot::scan(rootPath), resolver);
+}
+
+StockReportEngine::Result
+StockReportEngine::analyze(const EventSnapshot &snapshot,
+                           SectorResolver &resolver) {
+  Result r;
+  r.eventTitle = eventTitleForPath(snapshot.rootPath());
+
+  // Set Context
+  r.context = SectorResolver::detectStadiumContext(r.eventTitle);
+  resolver.setContext(r.context);
+
+  auto canon = [&resolver](const QString &sec) {
+    return resolver.canonicalName(sec);
+  };
+
+  // --- 1. Identify Folders ---
+  QString deliveredFolderName;
+  QString stockFolderName;
+
+  QStringList allDirs = snapshot.subdirs();
+  deliveredFolderName = findDeliveredFolder(allDirs);
+
+  // Find dedicated Stock Folder (Case Insensitive)
+  for (const QString &d : allDirs) {
+    if (d.compare("tickets", Qt::CaseInsensitive) == 0)
+      stockFolderName = d;
+    else if (d.compare("- Tickets -", Qt::CaseInsensitive) == 0)
+      stockFolderName = d;
+  }
+
+  auto addPlatformStat = [&](QString p, QString status, QString sec, int q) {
+    if (status.isEmpty())
+      status = "(empty folder)";
+    if (!status.startsWith("("))
+      status = "(" + status + ")";
+
+    r.platStat[p][status].qty += q;
+    r.platStat[p][status].sectorQty[canon(sec)] += q;
+    r.platTotals[p] += q;
+  };
+
+  // Regular Expressions for Parsing
+  // V19 Regex: Allows [A-Z0-9] in Row/Seat match (e.g., "45B-11-1D.pdf")
+  static QRegularExpression strictRe(R"((.+?)-([A-Z0-9]+)-([A-Z0-9]+)\.pdf)",
+                                     QRegularExpression::CaseInsensitiveOption);
+
+  // --- 2. Process Delivered ---
+  if (!deliveredFolderName.isEmpty()) {
+    for (const QString &d : snapshot.subtree(deliveredFolderName)) {
+      for (const QString &fName : snapshot.pdfs(d)) {
+        QRegularExpressionMatch match = strictRe.match(fName);
+        QString sec;
+        if (match.hasMatch()) {
+          sec = match.captured(1);
+        } else {
+          sec = EventSnapshot::nameOf(d);
+        }
+        r.deliveredMap[canon(sec)]++;
+      }
+    }
+  }
+
+  // --- 3. Process Stock Folder (if exists) ---
+  if (!stockFolderName.isEmpty()) {
+    // 1. Process Folders inside Stock
+    for (const QString &se : snapshot.subdirs(stockFolderName)) {
+      // NON-Recursive Scan (Match CalcStock)
+      QStringList pdfs =
+          snapshot.pdfs(EventSnapshot::join(stockFolderName, se));
+
+      for (const QString &fName : pdfs) {
+        QString cSec = sectorOf(fName);
+        if (!cSec.isEmpty()) {
+          r.stockMap[canon(cSec)]++;
+        }
+      }
+      // CalcStock ignores empty folders entirely. Do nothing.
+    }
+
+    // 2. Process Loose PDFs in Stock Root (CalcStock Logic)
+    for (const QString &f : snapshot.pdfs(stockFolderName)) {
+      QString cSec = sectorOf(f);
+      if (!cSec.isEmpty()) {
+        r.stockMap[canon(cSec)]++;
+      }
+    }
+  }
+
+  // --- 4. Process Root Folders & Root PDFs ---
+  for (const QString &e : allDirs) {
+    if (!deliveredFolderName.isEmpty() && e == deliveredFolderName)
+      continue;
+    if (!stockFolderName.isEmpty() && e == stockFolderName)
+      continue;
+    if (e.contains("IGNORE", Qt::CaseInsensitive))
+      continue;
+
+    // Strict Stock: Starts or Ends with hyphen
+    bool isStock = (e.startsWith("-") || e.endsWith("-")) &&
+                   !e.contains("BOUGHT", Qt::CaseInsensitive);
+
+    // FIX: If we found a main Stock Folder (e.g. "- Tickets -"), IGNORE other
+    // "stock-like" folders in root to strictly match CalcStock which only looks
+    // inside "- Tickets -".
+    if (!stockFolderName.isEmpty() && isStock) {
+      continue;
+    }
+
+    if (isStock) {
+      // Root Stock Folder (Only if no main stock folder found)
+      for (const QString &d : snapshot.subtree(e)) {
+        for (const QString &f : snapshot.pdfs(d)) {
+          QString cSec = sectorOf(f);
+          if (!cSec.isEmpty()) {
+            r.stockMap[canon(cSec)]++;
+          }
+        }
+      }
+
+    } else {
+      // Pending Order
+      QString status;
+      if (contains(e, "BOUGHT WITH NAMES"))
+        status = "Bought with names";
+      else if (contains(e, "need info"))
+        status = "Bought need info";
+      else if (contains(e, "BOUGHT"))
+        status = "Bought";
+
+      // A folder with PDFs counts them; without, the name's "xN" decides
+      int pdfCount = snapshot.pdfCount(e);
+      QPair<QString, int> info = parseSectorAndQuantity(e);
+      QString sec = info.first;
+      int qty = (pdfCount > 0) ? pdfCount : info.second;
+
+      r.pendingMap[canon(sec)] += qty;
+
+      QString platform = classifyPlatform(e);
+      addPlatformStat(platform, status, sec, qty);
+    }
+  }
+
+  // --- CALC NET STOCK & PREPARE DEBUG INFO ---
+  r.netStockMap = r.stockMap;
+
+  for (const QString &e : allDirs) {
+    if (!deliveredFolderName.isEmpty() && e == deliveredFolderName)
+      continue;
+    if (!stockFolderName.isEmpty() && e == stockFolderName)
+      continue;
+    if (e.contains("IGNORE", Qt::CaseInsensitive))
+      continue;
+
+    bool isStock = (e.startsWith("-") || e.endsWith("-")) &&
+                   !e.contains("BOUGHT", Qt::CaseInsensitive);
+    if (isStock)
+      continue;
+
+    bool isBought = contains(e, "BOUGHT");
+    if (isBought)
+      continue;
+
+    if (snapshot.pdfCount(e) > 0)
+      continue;
+
+    QPair<QString, int> info = parseSectorAndQuantity(e);
+    QString sec = info.first;
+    int qty = info.second;
+    QString c = canon(sec);
+
+    r.stockRequests[c] += qty;
+    r.debugSubtractionList[c].append(QString("%1 (x%2)").arg(e).arg(qty));
+  }
+
+  for (auto it = r.stockRequests.begin(); it != r.stockRequests.end(); ++it) {
+    r.netStockMap[it.key()] -= it.value();
+  }
+
+  return r;
+}
+
+// ---------------------------------------------------------
+// OUTPUT GENERATION
+// ---------------------------------------------------------
+
+QString StockReportEngine::renderText(const Result &r) {
+  QStringList out;
+  auto log = [&out](const QString &msg) { out.append(msg); };
+
+  QString dateStr = QDate::currentDate().toString("dd/MM/yyyy");
+
+  // Header
+  log(QString("*Report generated: %1 (v20)*").arg(dateStr));
+  log(QString("**Event: %1**").arg(r.eventTitle));
+  if (!r.context.isEmpty()) {
+    log(QString("Context: %1").arg(r.context));
+  }
+  log("");
+
+  auto printSection = [&](const QString &title, const QMap<QString, int> &map,
+                          int &total) {
+    log(QString("*%1*:").arg(title));
+    if (title != "Stock")
+      log("-------------------------");
+
+    total = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+      if (it.value() != 0) {
+        if (title == "Stock") {
+          int phys = r.stockMap.value(it.key());
+          int pend = r.stockRequests.value(it.key());
+          if (pend > 0) {
+            log(QString("%1: %2 (%3 Phys - %4 Requests)")
+                    .arg(it.key())
+                    .arg(it.value())
+                    .arg(phys)
+                    .arg(pend));
+          } else {
+            log(QString("%1: %2").arg(it.key()).arg(it.value()));
+          }
+        } else {
+          log(QString("%1: %2").arg(it.key()).arg(it.value()));
+        }
+        total += it.value();
+      }
+    }
+    log("-------------------------");
+    log(QString("*TOTAL %1*        : %2").arg(title).arg(total));
+    log("");
+  };
+
+  int tStock = 0;
+  printSection("Stock", r.netStockMap, tStock);
+
+  int tPend = 0;
+  printSection("Pending", r.pendingMap, tPend);
+
+  int tDeliv = 0;
+  printSection("Delivered", r.deliveredMap, tDeliv);
+
+  log("*Platform Sales (Summary)*");
+  log("-------------------------");
+  int grandSold = 0;
+  QStringList plats = r.platTotals.keys();
+  plats.sort();
+
+  for (const QString &p : plats) {
+    QStringList parts;
+    const QMap<QString, StatBreakdown> stats = r.platStat.value(p);
+    for (auto sit = stats.begin(); sit != stats.end(); ++sit) {
+      QString status = sit.key();
+      int qty = sit.value().qty;
+
+      QStringList secParts;
+      const QMap<QString, int> &smap = sit.value().sectorQty;
+      for (auto kit = smap.begin(); kit != smap.end(); ++kit) {
+        secParts << QString("x%1 %2").arg(kit.value()).arg(kit.key());
+      }
+      parts << QString("%1 %2 (%3)")
+                   .arg(status)
+                   .arg(qty)
+                   .arg(secParts.join(" + "));
+    }
+
+    if (!parts.isEmpty()) {
+      log(QString("%1        : %2").arg(p, -10).arg(parts[0]));
+      for (int i = 1; i < parts.size(); ++i) {
+        log(QString("              %1").arg(parts[i]));
+      }
+    }
+    grandSold += r.platTotals.value(p);
+  }
+  log("-------------------------");
+  log(QString("*TOTAL SOLD*          : %1").arg(grandSold));
+  log("");
+
+  log("*Stock Deduction Logic (Debug)*:");
+  log("---------------------------");
+  bool anyDebug = false;
+  for (auto it = r.debugSubtractionList.begin();
+       it != r.debugSubtractionList.end(); ++it) {
+    if (!it.value().isEmpty()) {
+      log(QString("Sector %1 deducted folders:").arg(it.key()));
+      for (const QString &f : it.value()) {
+        log(QString(" - %1").arg(f));
+      }
+      anyDebug = true;
+    }
+  }
+  if (!anyDebug)
+    log("No pending requests subtracted.");
+  log("---------------------------");
+
+  for (auto it = r.netStockMap.begin(); it != r.netStockMap.end(); ++it) {
+    if (it.value() < 0) {
+      log(QString("WARNING: Negative Stock for %1 (%2). Check mappings or "
+                  "missing stock tickets.")
+              .arg(it.key())
+              .arg(it.value()));
+    }
+  }
+
+  return out.join("\n");
+}
+
+} // namespace GOL
@@ -0,0 +1,64 @@
+#ifndef STOCKREPORTENGINE_H
+#define STOCKREPORTENGINE_H
+
+#include "EventSnapshot.h"
+#include "SectorResolver.h"
+#include <QDir>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+namespace GOL {
+
+// Stock vs pending vs delivered analysis behind StockReport.
+class StockReportEngine {
+public:
+  struct StatBreakdown {
+    int qty = 0;
+    QMap<QString, int> sectorQty;
+  };
+
+  struct Result {
+    QString eventTitle;
+    QString context;
+
+    QMap<QString, int> stockMap;      // Canonical Sector -> Count
+    QMap<QString, int> deliveredMap;  // Canonical Sector -> Count
+    QMap<QString, int> pendingMap;    // Canonical Sector -> Count
+    QMap<QString, int> netStockMap;   // Canonical Sector -> Net Count
+    QMap<QString, int> stockRequests; // Canonical Sector -> Requested
+
+    // Platform -> Status -> Breakdown
+    QMap<QString, QMap<QString, StatBreakdown>> platStat;
+    QMap<QString, int> platTotals;
+
+    QMap<QString, QStringList> debugSubtractionList;
+  };
+
+  // Walk up from rootPath until a non-generic folder name is found
+  static QString eventTitleForPath(const QString &rootPath);
+
+  // Sets the resolver context from the event title, then scans rootPath
+  static Result analyze(const QString &rootPath, SectorResolver &resolver);
+  // Same, over an already taken listing of the event folder
+  static Result analyze(const EventSnapshot &snapshot,
+                        SectorResolver &resolver);
+
+  // Plain-text report, identical to what StockReport shows and saves
+  static QString renderText(const Result &result);
+
+  static QString classifyPlatform(const QString &folderName);
+  static QPair<QString, int>
+  parseSectorAndQuantity(const QString &folderName,
+                         const QString &fullPath = "");
+  static int countPdfs(const QString &path);
+
+  // Helper to find "caricati" variations
+  static QString findDeliveredFolder(const QDir &rootDir);
+  static QString findDeliveredFolder(const QStringList &dirNames);
+};
+
+} // namespace GOL
+
+#endif // STOCKREPORTENGINE_H
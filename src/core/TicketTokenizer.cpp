@@ -0,0 +1,179 @@
+#include "TicketTokenizer.h"
+#include <climits>
+
+namespace GOL {
+
+static inline bool isDigit(char16_t c) { return c >= u'0' && c <= u'9'; }
+
+static inline bool isLetter(char16_t c) {
+  return (c >= u'A' && c <= u'Z') || (c >= u'a' && c <= u'z');
+}
+
+static inline char16_t lower(char16_t c) {
+  return (c >= u'A' && c <= u'Z') ? char16_t(c + 32) : c;
+}
+
+// Case-insensitive match of an ASCII lowercase word at s[i]
+static inline bool matchesAt(const QChar *s, qsizetype n, qsizetype i,
+                             const char16_t *word, qsizetype len) {
+  if (n - i < len)
+    return false;
+  for (qsizetype k = 0; k < len; ++k) {
+    if (lower(s[i + k].unicode()) != word[k])
+      return false;
+  }
+  return true;
+}
+
+// Length of the noise removed at s[i] by the old seat cleanup regex
+// "(?i)ticket|\.pdf|[^\d[A-Za-z]]", 0 if s[i] is kept.
+static inline qsizetype noiseAt(const QChar *s, qsizetype n, qsizetype i) {
+  if (matchesAt(s, n, i, u"ticket", 6))
+    return 6;
+  if (matchesAt(s, n, i, u".pdf", 4))
+    return 4;
+
+  char16_t c = s[i].unicode();
+  if (isDigit(c) || isLetter(c) || c == u'[')
+    return 0;
+  // One code point (a surrogate pair counts as one) followed by ']'
+  qsizetype cp = (s[i].isHighSurrogate() && i + 1 < n &&
+                  s[i + 1].isLowSurrogate())
+                     ? 2
+                     : 1;
+  if (i + cp < n && s[i + cp].unicode() == u']')
+    return cp + 1;
+  return 0;
+}
+
+TicketTokenizer::Tokens TicketTokenizer::tokenize(QStringView fileName) {
+  Tokens t;
+  const QChar *s = fileName.data();
+  const qsizetype n = fileName.size();
+
+  // Base name: after the last separator, up to the first '.'
+  qsizetype begin = 0;
+  for (qsizetype i = 0; i < n; ++i) {
+    char16_t c = s[i].unicode();
+    if (c == u'/' || c == u'\\')
+      begin = i + 1;
+  }
+  qsizetype end = begin;
+  while (end < n && s[end].unicode() != u'.')
+    ++end;
+
+  // Everything from the first "-FV" on is the price tag
+  for (qsizetype i = begin; i + 2 < end; ++i) {
+    if (s[i].unicode() == u'-' && matchesAt(s, end, i + 1, u"fv", 2)) {
+      end = i;
+      break;
+    }
+  }
+
+  // First three non-empty parts separated by '-' or ' '
+  QStringView *parts[3] = {&t.sector, &t.row, &t.seat};
+  int found = 0;
+  qsizetype i = begin;
+  while (found < 3 && i < end) {
+    while (i < end && (s[i].unicode() == u'-' || s[i].unicode() == u' '))
+      ++i;
+    qsizetype start = i;
+    while (i < end && s[i].unicode() != u'-' && s[i].unicode() != u' ')
+      ++i;
+    if (i > start)
+      *parts[found++] = fileName.sliced(start, i - start);
+  }
+  if (found < 3)
+    t.sector = t.row = t.seat = QStringView();
+
+  // Face value: first "FV" followed by a digit anywhere in the name
+  for (qsizetype j = 0; j + 2 < n; ++j) {
+    if (!matchesAt(s, n, j, u"fv", 2) || !isDigit(s[j + 2].unicode()))
+      continue;
+    qsizetype k = j + 2;
+    while (k < n && isDigit(s[k].unicode()))
+      ++k;
+    if (k + 1 < n && lower(s[k].unicode()) == u'p' &&
+        isDigit(s[k + 1].unicode())) {
+      k += 1;
+      while (k < n && isDigit(s[k].unicode()))
+        ++k;
+    }
+    t.faceValue = fileName.sliced(j + 2, k - j - 2);
+    break;
+  }
+
+  return t;
+}
+
+TicketTokenizer::Seat TicketTokenizer::parseSeat(QStringView seat) {
+  Seat r;
+  const QChar *s = seat.data();
+  const qsizetype n = seat.size();
+
+  // Walk the cleaned character stream without building it: noise is skipped
+  // in place, so "1ticket2" still reads as seat 12.
+  qsizetype i = 0;
+  auto nextKept = [&]() {
+    for (qsizetype skip; i < n && (skip = noiseAt(s, n, i)) > 0;)
+      i += skip;
+  };
+
+  // First digit run
+  for (nextKept(); i < n && !isDigit(s[i].unicode()); nextKept())
+    ++i;
+  if (i >= n)
+    return r;
+
+  qint64 value = 0;
+  for (; i < n && isDigit(s[i].unicode()); nextKept()) {
+    if (value <= INT_MAX)
+      value = value * 10 + (s[i].unicode() - u'0');
+    ++i;
+  }
+  r.hasNumber = true;
+  r.num = value <= INT_MAX ? int(value) : 0; // QString::toInt overflow
+
+  // Letters following it
+  qsizetype sufStart = -1;
+  qsizetype sufEnd = -1;
+  for (; i < n && isLetter(s[i].unicode()); nextKept()) {
+    if (sufStart < 0)
+      sufStart = i;
+    else if (i != sufEnd)
+      r.suffixHasGaps = true;
+    sufEnd = ++i;
+  }
+  if (sufStart >= 0)
+    r.suffix = seat.sliced(sufStart, sufEnd - sufStart);
+  return r;
+}
+
+QString TicketTokenizer::Seat::suffixString() const {
+  if (!suffixHasGaps)
+    return suffix.toString();
+
+  QString out;
+  const QChar *s = suffix.data();
+  const qsizetype n = suffix.size();
+  for (qsizetype i = 0; i < n;) {
+    qsizetype skip = noiseAt(s, n, i);
+    if (skip > 0) {
+      i += skip;
+    } else {
+      out.append(s[i]);
+      ++i;
+    }
+  }
+  return out;
+}
+
+QString TicketTokenizer::formatFaceValue(QStringView faceValue) {
+  if (faceValue.isNull())
+    return "N/A";
+  QString val = faceValue.toString();
+  val.replace('p', '.'); // Only lowercase, like the old helper
+  return val + "€";
+}
+
+} // namespace GOL
@@ -0,0 +1,46 @@
+#ifndef TICKETTOKENIZER_H
+#define TICKETTOKENIZER_H
+
+#include <QString>
+#include <QStringView>
+
+namespace GOL {
+
+// Single left-to-right pass over a ticket filename such as
+// "118-12-7A-FV45p50.pdf". Every token is a view into the input, so nothing
+// is allocated; the results match the old regex helpers in StockEngine.
+class TicketTokenizer {
+public:
+  struct Tokens {
+    QStringView sector; // As written; StockEngine upper-cases it
+    QStringView row;
+    QStringView seat;
+    QStringView faceValue; // "45p50" (without "FV"), null if missing
+
+    bool isValid() const { return !seat.isEmpty(); }
+  };
+
+  struct Seat {
+    int num = 0;
+    QStringView suffix;     // Letters right after the number
+    bool hasNumber = false; // false: old parser returned {0, seatStr}
+    bool suffixHasGaps = false;
+
+    // Suffix with "ticket", "-]"... removed, as the old parser returned it
+    QString suffixString() const;
+  };
+
+  // Sector / row / seat from the base name (cut at "-FV", split on '-' and
+  // ' ') plus the first "FV<digits>[p<digits>]" anywhere in the name.
+  static Tokens tokenize(QStringView fileName);
+
+  // Number + letter suffix, ignoring "ticket", ".pdf" and "x]" noise
+  static Seat parseSeat(QStringView seat);
+
+  // "45p50" -> "45.50€", null -> "N/A"
+  static QString formatFaceValue(QStringView faceValue);
+};
+
+} // namespace GOL
+
+#endif // TICKETTOKENIZER_H
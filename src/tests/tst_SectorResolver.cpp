@@ -0,0 +1,79 @@
+// SectorResolver context rules: blocks match as whole words the way the old
+// per-block \bBLOCK\b regex did, with ASCII word characters only.
+
+#include "core/PriceEngine.h"
+#include "core/SectorResolver.h"
+#include <QTest>
+
+using namespace GOL;
+
+class TestSectorResolver : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void canonicalName_data();
+  void canonicalName();
+  void listingSector();
+
+private:
+  SectorResolver m_resolver;
+};
+
+void TestSectorResolver::initTestCase() {
+  QVERIFY(m_resolver.loadSectorDB(QFINDTESTDATA("data/sector_db.json")));
+  m_resolver.setContext("roma");
+}
+
+void TestSectorResolver::canonicalName_data() {
+  QTest::addColumn<QString>("raw");
+  QTest::addColumn<QString>("expected");
+
+  QTest::newRow("block") << "18AD" << "CURVA";
+  QTest::newRow("lower case") << "18ad" << "CURVA";
+  QTest::newRow("sector prefix") << "Sector 15A" << "DISTINTI";
+  QTest::newRow("inside text") << "Roma 18B x2" << "CURVA";
+  QTest::newRow("letter after") << "18ADX" << "18ADX";
+  QTest::newRow("underscore after") << "18AD_1" << "18AD_1";
+  QTest::newRow("digit before") << "118AD" << "118AD";
+  // Non-ASCII letters are not word characters for \b
+  QTest::newRow("accent after") << "18ADé" << "CURVA";
+  QTest::newRow("accent before") << "é18B" << "CURVA";
+  QTest::newRow("no rule") << "Tribuna" << "TRIBUNA";
+}
+
+void TestSectorResolver::canonicalName() {
+  QFETCH(QString, raw);
+  QFETCH(QString, expected);
+  QCOMPARE(m_resolver.canonicalName(raw), expected);
+}
+
+// A listing's sector is its first field the resolver recognizes, even when
+// that field is already spelled like its canonical name
+void TestSectorResolver::listingSector() {
+  QString ok;
+  QVERIFY(m_resolver.resolve("Curva", &ok));
+  QCOMPARE(ok, QString("CURVA"));
+  QString unknown;
+  QVERIFY(!m_resolver.resolve("Tribuna", &unknown));
+  QCOMPARE(unknown, QString("TRIBUNA"));
+
+  auto listing = [](const char *category, const char *block) {
+    return QString("<div class=\"stand_Sprice desktop\">"
+                   "<div class=\"category\">%1</div>"
+                   "<div class=\"block\">Block: %2</div>"
+                   "<span class=\"price\">€ 80.00</span></div>\n")
+        .arg(category, block);
+  };
+  MarketSnapshot ftn;
+  ftn.platform = Platform::FTN;
+  ftn.html = listing("Category 1", "Curva") + listing("Category 1", "Tribuna");
+
+  QList<PriceRecord> records = PriceEngine::sectorRecords({ftn}, m_resolver);
+  QCOMPARE(records.size(), 2);
+  QCOMPARE(records[0].sector, QString("CURVA")); // Not "Category 1"'s sector
+  QCOMPARE(records[1].sector, QString("TERZO ROSSO")); // Block unknown
+}
+
+QTEST_APPLESS_MAIN(TestSectorResolver)
+#include "tst_SectorResolver.moc"
@@ -0,0 +1,135 @@
+// TicketTokenizer against the regex helpers it replaced in StockEngine.
+// The old code is kept here verbatim; every name must parse the same way.
+
+#include "core/StockEngine.h"
+#include "core/TicketTokenizer.h"
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTest>
+
+using namespace GOL;
+
+namespace Regex {
+
+std::tuple<QString, QString, QString>
+extractSrsFromFilename(const QString &filename) {
+  QString cleanName = QFileInfo(filename).baseName();
+  QRegularExpression fvRe("-FV.*", QRegularExpression::CaseInsensitiveOption);
+  cleanName.remove(fvRe);
+  QStringList parts =
+      cleanName.split(QRegularExpression("[- ]"), Qt::SkipEmptyParts);
+  if (parts.size() >= 3) {
+    return {parts[0].toUpper(), parts[1], parts[2]};
+  }
+  return {};
+}
+
+QString extractFvFromFilename(const QString &filename) {
+  QRegularExpression re("FV(\\d+(?:p\\d+)?)(?![0-9])",
+                        QRegularExpression::CaseInsensitiveOption);
+  QRegularExpressionMatch match = re.match(filename);
+  if (match.hasMatch()) {
+    QString val = match.captured(1);
+    val.replace('p', '.');
+    return val + "€";
+  }
+  return "N/A";
+}
+
+std::pair<int, QString> parseSeatDetailed(const QString &seatStr) {
+  QString clean = seatStr;
+  clean.remove(QRegularExpression("(?i)ticket|\\.pdf|[^\\d[A-Za-z]]"));
+  QRegularExpression re("(\\d+)([A-Za-z]*)");
+  QRegularExpressionMatch match = re.match(clean);
+  if (match.hasMatch()) {
+    return {match.captured(1).toInt(), match.captured(2)};
+  }
+  return {0, seatStr};
+}
+
+} // namespace Regex
+
+class TestTicketTokenizer : public QObject {
+  Q_OBJECT
+
+private slots:
+  void fileName_data();
+  void fileName();
+  void seat_data();
+  void seat();
+};
+
+void TestTicketTokenizer::fileName_data() {
+  QTest::addColumn<QString>("name");
+
+  const QStringList names = {
+      "118-12-7A-FV45p50.pdf",
+      "EXTRA-1-3-FV25.pdf",
+      "A B C.pdf",
+      "118 12 7.pdf",
+      "118--12---7.pdf",
+      "118-12.pdf",                // Too few parts
+      "118-12-7-FV.pdf",           // FV without digits
+      "118-12-7-fv12P5.pdf",       // Only a lower-case 'p' becomes '.'
+      "curva.nord-1-2.pdf",        // Base name stops at the first dot
+      "FV12-1-2-3.pdf",            // "FV" not preceded by '-'
+      "118-12-7A-FV45p501.pdf",
+      "118-12-7A-FV45p50 (1).pdf", // Copy suffix
+      "tribuna-3-12-FV1p5p6.pdf",
+  };
+  for (const QString &name : names)
+    QTest::addRow("%s", qPrintable(name)) << name;
+}
+
+void TestTicketTokenizer::fileName() {
+  QFETCH(QString, name);
+
+  auto expected = Regex::extractSrsFromFilename(name);
+  QCOMPARE(StockEngine::extractSrsFromFilename(name), expected);
+  QCOMPARE(StockEngine::extractFvFromFilename(name),
+           Regex::extractFvFromFilename(name));
+
+  // StockReportEngine reads the sector straight from the tokens
+  TicketTokenizer::Tokens t = TicketTokenizer::tokenize(name);
+  QCOMPARE(t.isValid() ? t.sector.toString().toUpper() : QString(),
+           std::get<0>(expected));
+}
+
+void TestTicketTokenizer::seat_data() {
+  QTest::addColumn<QString>("seat");
+
+  const QStringList seats = {
+      "7A",
+      "12",
+      "Ticket 12B",
+      "ticket12.pdf",
+      "12.PDF",
+      "12-]A",     // [^\d[A-Za-z]] drops a non-alphanumeric before ']'
+      "3]B",       // ... but not a digit before ']'
+      "x]5",       // ... nor a letter
+      "[7]C",      // ... nor '['
+      "é]4",
+      "🎫]12",      // One code point before ']'
+      "TICKET-]9c",
+      "A1",
+      "abc",       // No digits: {0, input}
+      "",
+      "2147483647",
+      "2147483648", // toInt overflow gives 0
+      "99999999999B",
+      "12 B",
+      "1é",
+  };
+  for (const QString &seat : seats)
+    QTest::addRow("%s", seat.isEmpty() ? "(empty)" : qPrintable(seat))
+        << seat;
+}
+
+void TestTicketTokenizer::seat() {
+  QFETCH(QString, seat);
+  QCOMPARE(StockEngine::parseSeatDetailed(seat),
+           Regex::parseSeatDetailed(seat));
+}
+
+QTEST_APPLESS_MAIN(TestTicketTokenizer)
+#include "tst_TicketTokenizer.moc"
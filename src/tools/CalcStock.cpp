@@ -1,6 +1,9 @@
 #include "CalcStock.h"
 #include "../SecurityManager.h"
 #include "../Utils.h"
+#include "../core/FolderWatcher.h"
+#include "../core/StockEngine.h"
+#include "../core/StockManifest.h"
 #include <QDateTime>
 #include <QDir>
 #include <QFile>
@@ -10,6 +13,7 @@
 #include <QRegularExpression>
 #include <QStandardPaths>
 #include <QTextStream>
+#include <QTime>
 #include <QVBoxLayout>
 
 namespace GOL {
@@ -54,8 +58,18 @@ CalcStock::CalcStock(QWidget *parent) : QDialog(parent) {
   m_oddEvenMode = new QCheckBox("Odd-Even Mode (ex: Fiorentina events)");
   m_oddEvenMode->setStyleSheet("font-size: 15px; color: #AAB;");
   mainLayout->addWidget(m_oddEvenMode);
+
+  m_liveMode = new QCheckBox("Live Mode (update report when folders change)");
+  m_liveMode->setStyleSheet("font-size: 15px; color: #AAB;");
+  connect(m_liveMode, &QCheckBox::toggled, this, &CalcStock::toggleLiveMode);
+  mainLayout->addWidget(m_liveMode);
   mainLayout->addSpacing(15);
 
+  // "- Tickets -" and its category folders
+  m_watcher = new FolderWatcher(this);
+  connect(m_watcher, &FolderWatcher::foldersChanged, this,
+          &CalcStock::onFoldersChanged);
+
   QPushButton *generateBtn = new QPushButton("🚀 GENERATE & SAVE REPORT");
   generateBtn->setFixedHeight(60);
   generateBtn->setStyleSheet(
@@ -75,10 +89,14 @@ CalcStock::CalcStock(QWidget *parent) : QDialog(parent) {
   mainLayout->addWidget(m_logArea);
 }
 
+CalcStock::~CalcStock() = default;
+
 void CalcStock::browsePath() {
   QString path = QFileDialog::getExistingDirectory(this, "Select Event Folder");
   if (!path.isEmpty()) {
     m_pathInput->setText(path);
+    if (m_liveMode->isChecked())
+      runCalculation(); // Move the watcher to the new event
   }
 }
 
@@ -90,217 +108,6 @@ void CalcStock::log(const QString &msg, bool clear) {
   QCoreApplication::processEvents();
 }
 
-// ---------------------------------------------------------
-// STATIC LOGIC
-// ---------------------------------------------------------
-
-std::tuple<QString, QString, QString>
-CalcStock::extractSrsFromFilename(const QString &filename) {
-  // Logic from python: remove -FV..., split by [- ], take first 3 parts
-  QString cleanName = QFileInfo(filename).baseName();
-
-  // Remove -FV... part
-  QRegularExpression fvRe("-FV.*", QRegularExpression::CaseInsensitiveOption);
-  cleanName.remove(fvRe);
-
-  // Split by - or space
-  QStringList parts =
-      cleanName.split(QRegularExpression("[- ]"), Qt::SkipEmptyParts);
-  if (parts.size() >= 3) {
-    return {parts[0].toUpper(), parts[1], parts[2]};
-  }
-  return {};
-}
-
-QString CalcStock::extractFvFromFilename(const QString &filename) {
-  QRegularExpression re("FV(\\d+(?:p\\d+)?)(?![0-9])",
-                        QRegularExpression::CaseInsensitiveOption);
-  QRegularExpressionMatch match = re.match(filename);
-  if (match.hasMatch()) {
-    QString val = match.captured(1);
-    val.replace('p', '.');
-    return val + "€";
-  }
-  return "N/A";
-}
-
-std::pair<int, QString> CalcStock::parseSeatDetailed(const QString &seatStr) {
-  // Remove "ticket", ".pdf", key chars
-  QString clean = seatStr;
-  clean.remove(QRegularExpression("(?i)ticket|\\.pdf|[^\\d[A-Za-z]]"));
-
-  QRegularExpression re("(\\d+)([A-Za-z]*)");
-  QRegularExpressionMatch match = re.match(clean);
-
-  if (match.hasMatch()) {
-    return {match.captured(1).toInt(), match.captured(2)};
-  }
-  return {0, seatStr};
-}
-
-QList<QList<CalcStock::SeatInfo>>
-CalcStock::findConsecutiveGroups(QList<CalcStock::SeatInfo> &seats, int step) {
-  if (seats.isEmpty())
-    return {};
-
-  // Sort by suffix then number
-  std::sort(seats.begin(), seats.end(),
-            [](const CalcStock::SeatInfo &a, const CalcStock::SeatInfo &b) {
-              if (a.suffix != b.suffix)
-                return a.suffix < b.suffix;
-              return a.num < b.num;
-            });
-
-  QList<QList<SeatInfo>> groups;
-  QList<SeatInfo> currentGroup;
-  currentGroup.append(seats[0]);
-
-  for (int i = 1; i < seats.size(); ++i) {
-    const SeatInfo &prev = seats[i - 1];
-    const SeatInfo &curr = seats[i];
-
-    bool isConsecutive =
-        (curr.num == prev.num + step) && (curr.suffix == prev.suffix);
-    if (isConsecutive) {
-      currentGroup.append(curr);
-    } else {
-      groups.append(currentGroup);
-      currentGroup.clear();
-      currentGroup.append(curr);
-    }
-  }
-  groups.append(currentGroup);
-  return groups;
-}
-
-QString CalcStock::generateReportContent(const QString &basePath,
-                                         bool oddEvenMode) {
-  if (basePath.isEmpty())
-    return "";
-
-  QString ticketsPath = basePath + "/- Tickets -";
-  if (!QDir(ticketsPath).exists()) {
-    return "ERROR_NO_TICKETS_FOLDER";
-  }
-
-  int step = oddEvenMode ? 2 : 1;
-  QStringList reportBody;
-  int grandTotal = 0;
-
-  struct ProcessItem {
-    QString name;
-    QStringList pdfs;
-    QString path;
-  };
-  QList<ProcessItem> itemsToProcess;
-
-  // Check for loose PDFs in - Tickets - root
-  QDir ticketsDir(ticketsPath);
-  QStringList loosePdfs =
-      ticketsDir.entryList(QStringList() << "*.pdf", QDir::Files);
-  if (!loosePdfs.isEmpty()) {
-    itemsToProcess.append({"- Extra without folder -", loosePdfs, ticketsPath});
-  }
-
-  // Check subdirectories
-  QStringList subDirs = ticketsDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-
-  for (const QString &d : subDirs) {
-    QString subPath = ticketsPath + "/" + d;
-    QDir subDir(subPath);
-    QStringList pdfs = subDir.entryList(QStringList() << "*.pdf", QDir::Files);
-    if (!pdfs.isEmpty()) {
-      itemsToProcess.append({d, pdfs, subPath});
-    }
-  }
-
-  // Process logic
-  for (const auto &item : itemsToProcess) {
-    reportBody.append(QString("📂 %1").arg(item.name));
-    reportBody.append(QString("🥅 TOTAL: %1").arg(item.pdfs.size()));
-    grandTotal += item.pdfs.size();
-
-    // Organize by Sector -> Row -> List of Seats
-    QMap<QString, QMap<QString, QList<CalcStock::SeatInfo>>> data;
-    QMap<QString, QString> priceMap; // Key: "Sec|Row"
-
-    for (const QString &f : item.pdfs) {
-      auto [sec, row, seatStr] = extractSrsFromFilename(f);
-      if (!sec.isEmpty()) {
-        auto [num, suffix] = parseSeatDetailed(seatStr);
-        data[sec][row].append({QString::number(num) + suffix, num, suffix});
-
-        QString key = sec + "|" + row;
-        if (!priceMap.contains(key)) {
-          priceMap[key] = extractFvFromFilename(f);
-        }
-      }
-    }
-
-    // Generate text for this category
-    for (auto itSec = data.begin(); itSec != data.end(); ++itSec) {
-      QString sec = itSec.key();
-      QStringList secCounts;
-      QStringList secGroupsInfo;
-      int secTotal = 0;
-
-      // Sort rows naturally
-      QStringList rows = itSec.value().keys();
-      std::sort(rows.begin(), rows.end(),
-                [](const QString &a, const QString &b) {
-                  // Try number sort if possible
-                  bool ok1, ok2;
-                  int n1 = a.toInt(&ok1);
-                  int n2 = b.toInt(&ok2);
-                  if (ok1 && ok2)
-                    return n1 < n2;
-                  return a < b;
-                });
-
-      for (const QString &row : rows) {
-        QList<CalcStock::SeatInfo> &seats = itSec.value()[row];
-        auto groups = findConsecutiveGroups(seats, step);
-
-        for (const auto &g : groups) {
-          int qty = g.size();
-          secTotal += qty;
-          secCounts.append(QString::number(qty));
-
-          QString range;
-          if (qty > 1)
-            range = QString("%1/%2").arg(g.first().raw, g.last().raw);
-          else
-            range = g.first().raw;
-
-          QString price = priceMap.value(sec + "|" + row, "N/A");
-          secGroupsInfo.append(QString("💺Row: %1 Seat: %2 Qty: %3 [%4]")
-                                   .arg(row, range)
-                                   .arg(qty)
-                                   .arg(price));
-        }
-      }
-
-      QString breakdown = secCounts.join("+");
-      reportBody.append(QString("🎫 Sector: %1 Total: %2 | %3")
-                            .arg(sec)
-                            .arg(secTotal)
-                            .arg(breakdown));
-      reportBody.append(secGroupsInfo);
-    }
-    reportBody.append(""); // Empty line
-  }
-
-  QStringList header;
-  QString eventName = QFileInfo(basePath).fileName();
-  header << QString("⚽ EVENT: %1").arg(eventName);
-  header << QString("📅 DATE: %1")
-                .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm"));
-  header << QString("🥅 GRAND TOTAL: %1").arg(grandTotal);
-  header << "========================================\n";
-
-  return header.join("\n") + "\n" + reportBody.join("\n");
-}
-
 void CalcStock::runCalculation() {
   // Security Check
   SecurityManager::instance().checkAndAct();
@@ -313,14 +120,37 @@ void CalcStock::runCalculation() {
 
   log("⏳ Processing...", true);
 
-  QString finalReport =
-      generateReportContent(basePath, m_oddEvenMode->isChecked());
+  // Only folders changed since the last run are re-read
+  bool oddEven = m_oddEvenMode->isChecked();
+  if (!m_manifest || m_manifest->basePath() != basePath ||
+      m_manifest->oddEvenMode() != oddEven) {
+    m_manifest = std::make_unique<StockManifest>(basePath, oddEven);
+    m_manifest->load();
+  }
+  QString finalReport = m_manifest->refresh();
 
-  if (finalReport == "ERROR_NO_TICKETS_FOLDER") {
+  if (finalReport == StockEngine::ERROR_NO_TICKETS_FOLDER) {
+    m_watcher->stop();
     log("❌ ERROR: '- Tickets -' folder not found.", true);
     return;
   }
+  m_manifest->save();
 
+  QString outputFile = saveReport(basePath, finalReport);
+  if (!outputFile.isEmpty()) {
+    log(finalReport);
+    log(QString("\n✅ SUCCESS! Report saved to:\n%1").arg(outputFile));
+  } else {
+    log("❌ ERROR: Could not save report file.");
+  }
+
+  if (m_liveMode->isChecked()) {
+    m_watcher->watch(basePath + "/- Tickets -", 1);
+    log("🟢 LIVE: watching '- Tickets -' for changes...");
+  }
+}
+
+QString CalcStock::saveReport(const QString &basePath, const QString &report) {
   // Setup output
   QString desktop =
       QStandardPaths::writableLocation(QStandardPaths::DesktopLocation);
@@ -334,20 +164,54 @@ void CalcStock::runCalculation() {
       QString("%1/Stock_%2.txt").arg(stockFolder, safeEventName);
 
   QFile file(outputFile);
-  if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-    QTextStream out(&file);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    return QString();
+
+  QTextStream out(&file);
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    out.setEncoding(QStringConverter::Utf8);
+  out.setEncoding(QStringConverter::Utf8);
 #else
-    out.setCodec("UTF-8");
+  out.setCodec("UTF-8");
 #endif
-    out << finalReport;
-    file.close();
-    log(finalReport);
-    log(QString("\n✅ SUCCESS! Report saved to:\n%1").arg(outputFile));
-  } else {
-    log("❌ ERROR: Could not save report file.");
+  out << report;
+  file.close();
+  return outputFile;
+}
+
+void CalcStock::toggleLiveMode(bool on) {
+  if (!on) {
+    m_watcher->stop();
+    log("⚪ LIVE: stopped.");
+    return;
   }
+  // First scan (or catch-up) also starts the watcher
+  if (!m_pathInput->text().trimmed().isEmpty())
+    runCalculation();
+}
+
+void CalcStock::onFoldersChanged(const QStringList &folders) {
+  if (!m_manifest)
+    return;
+
+  for (const QString &folder : folders)
+    m_manifest->markChanged(folder);
+  QString report = m_manifest->refresh();
+
+  if (report == StockEngine::ERROR_NO_TICKETS_FOLDER) {
+    m_watcher->stop();
+    log("❌ LIVE: '- Tickets -' folder disappeared, live mode stopped.");
+    return;
+  }
+  if (m_manifest->rescannedCategories() == 0)
+    return;
+  m_manifest->save();
+
+  QString outputFile = saveReport(m_manifest->basePath(), report);
+  log(report, true);
+  log(QString("\n🔄 LIVE %1: %2 folder(s) re-read%3")
+          .arg(QTime::currentTime().toString("HH:mm:ss"))
+          .arg(m_manifest->rescannedCategories())
+          .arg(outputFile.isEmpty() ? ", report NOT saved" : ""));
 }
 
 } // namespace GOL
@@ -8,52 +8,38 @@
 #include <QPushButton>
 #include <QString>
 #include <QTextEdit>
-#include <tuple>
-#include <utility>
+#include <memory>
 
 namespace GOL {
 
+class FolderWatcher;
+class StockManifest;
+
 class CalcStock : public QDialog {
   Q_OBJECT
 
 public:
-  struct SeatInfo {
-    QString raw;
-    int num;
-    QString suffix;
-  };
-
-  struct GroupInfo {
-    QString rawStart;
-    QString rawEnd;
-    int qty;
-  };
-
   explicit CalcStock(QWidget *parent = nullptr);
+  ~CalcStock() override;
 
 private slots:
   void browsePath();
   void runCalculation();
-
-public:
-  // Logic helpers - made static for reuse
-  static std::tuple<QString, QString, QString>
-  extractSrsFromFilename(const QString &filename);
-  static QString extractFvFromFilename(const QString &filename);
-  static std::pair<int, QString> parseSeatDetailed(const QString &seatStr);
-  static QList<QList<SeatInfo>> findConsecutiveGroups(QList<SeatInfo> &seats,
-                                                      int step);
-
-  // Main static Generator
-  static QString generateReportContent(const QString &basePath,
-                                       bool oddEvenMode);
+  void toggleLiveMode(bool on);
+  void onFoldersChanged(const QStringList &folders);
 
 private:
   void log(const QString &msg, bool clear = false);
+  QString saveReport(const QString &basePath, const QString &report);
 
   QLineEdit *m_pathInput;
   QCheckBox *m_oddEvenMode;
+  QCheckBox *m_liveMode;
   QTextEdit *m_logArea;
+
+  // Kept between runs so live updates only re-read changed folders
+  std::unique_ptr<StockManifest> m_manifest;
+  FolderWatcher *m_watcher;
 };
 
 } // namespace GOL
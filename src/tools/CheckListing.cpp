@@ -2,19 +2,22 @@
 #include "../CosmicDialog.h"
 #include "../SecurityManager.h"
 #include "../Utils.h"
-#include "CalcStock.h" // Added for static logic
+#include "../core/ListingEngine.h"
+#include "../core/StockEngine.h"
+#include "../core/StockManifest.h"
+#include "ListingTableModel.h"
 #include <QApplication>
 #include <QClipboard>
-#include <QFile>
+#include <QDateTime>
+#include <QDir>
 #include <QFileDialog> // Needed for file dialog
 #include <QHBoxLayout>
+#include <QHeaderView>
 #include <QInputDialog>
 #include <QLabel>
 #include <QMap>
 #include <QMessageBox>
 #include <QRegularExpression>
-#include <QScrollArea>
-#include <QSet>
 #include <QStandardPaths>
 #include <QTextStream>
 #include <QtConcurrent/QtConcurrent>
@@ -32,11 +35,23 @@ CheckListing::CheckListing(QWidget *parent) : QDialog(parent) {
   setupUI();
 
   // Initial rows
-  for (int i = 0; i < 10; ++i)
-    addRow();
+  m_listingModel->appendRows(10);
 
-  connect(&m_calcWatcher, &QFutureWatcher<QString>::finished, this,
+  using CalcWatcher = QFutureWatcher<StockModel::Event>;
+  connect(&m_calcWatcher, &CalcWatcher::finished, this,
           &CheckListing::onCalcFinished);
+  using AllocWatcher = QFutureWatcher<ListingEngine::AllocationResult>;
+  connect(&m_allocWatcher, &AllocWatcher::finished, this,
+          &CheckListing::onAllocFinished);
+  connect(&m_allocWatcher, &AllocWatcher::progressValueChanged, this,
+          &CheckListing::onAllocProgress);
+  using BatchWatcher = QFutureWatcher<ListingEngine::EventAllocation>;
+  connect(&m_batchWatcher, &BatchWatcher::finished, this,
+          &CheckListing::onBatchFinished);
+  connect(&m_batchWatcher, &BatchWatcher::progressValueChanged, this,
+          &CheckListing::onBatchProgress);
+  connect(&m_batchWatcher, &BatchWatcher::resultReadyAt, this,
+          &CheckListing::onBatchResult);
 }
 
 void CheckListing::setupUI() {
@@ -166,17 +181,27 @@ void CheckListing::setupUI() {
 
   leftCol->addWidget(tableHeader);
 
-  QScrollArea *scroll = new QScrollArea();
-  scroll->setWidgetResizable(true);
-  scroll->setStyleSheet(
-      "QScrollArea { border: none; background-color: transparent; }");
-  QWidget *rowsScrollWidget = new QWidget();
-  m_rowsLayout = new QVBoxLayout(rowsScrollWidget);
-  m_rowsLayout->setContentsMargins(0, 0, 0, 0);
-  m_rowsLayout->setSpacing(5);
-  m_rowsLayout->addStretch(); // Important for pinning rows to top
-  scroll->setWidget(rowsScrollWidget);
-  leftCol->addWidget(scroll);
+  // Only visible rows are painted; cells are edited through the delegate
+  m_listingModel = new ListingTableModel(this);
+  m_listingView = new QTableView();
+  m_listingView->setModel(m_listingModel);
+  m_listingView->setItemDelegate(new ListingCellDelegate(m_listingView));
+  // The header row above (with the import buttons) stays the column header
+  m_listingView->horizontalHeader()->hide();
+  m_listingView->verticalHeader()->hide();
+  m_listingView->verticalHeader()->setDefaultSectionSize(40);
+  m_listingView->setColumnWidth(ListingTableModel::SectorColumn, 110);
+  m_listingView->setColumnWidth(ListingTableModel::GogoColumn, 190);
+  m_listingView->setColumnWidth(ListingTableModel::NetColumn, 190);
+  m_listingView->setColumnWidth(ListingTableModel::TixColumn, 190);
+  m_listingView->setShowGrid(false);
+  m_listingView->setEditTriggers(QAbstractItemView::AllEditTriggers);
+  m_listingView->setStyleSheet(
+      "QTableView { border: none; background-color: transparent; "
+      "margin-left: 10px; }"
+      "QTableView::item { background-color: #0d0d0d; border-radius: 4px; "
+      "margin: 2px; }");
+  leftCol->addWidget(m_listingView);
 
   QPushButton *btnAdd = new QPushButton("+ ADD NEW SECTOR ROW");
   btnAdd->setFixedHeight(35);
@@ -210,14 +235,14 @@ void CheckListing::setupUI() {
   QHBoxLayout *actionLayout = new QHBoxLayout(actionBar);
   actionLayout->setContentsMargins(40, 0, 40, 0);
 
-  QPushButton *btnProcess = new QPushButton("🚀  GENERATE FINAL STOCK");
-  btnProcess->setFixedHeight(50);
-  btnProcess->setFixedWidth(300);
-  btnProcess->setCursor(Qt::PointingHandCursor);
-  btnProcess->setObjectName(
+  m_btnGenerate = new QPushButton("🚀  GENERATE FINAL STOCK");
+  m_btnGenerate->setFixedHeight(50);
+  m_btnGenerate->setFixedWidth(300);
+  m_btnGenerate->setCursor(Qt::PointingHandCursor);
+  m_btnGenerate->setObjectName(
       "btnGenerate"); // Changed object name to "btnGenerate"
-  connect(btnProcess, &QPushButton::clicked, this, &CheckListing::process);
-  actionLayout->addWidget(btnProcess);
+  connect(m_btnGenerate, &QPushButton::clicked, this, &CheckListing::process);
+  actionLayout->addWidget(m_btnGenerate);
 
   QPushButton *btnReset = new QPushButton("🗑️  RESET ALL");
   btnReset->setFixedHeight(50);
@@ -226,6 +251,22 @@ void CheckListing::setupUI() {
   connect(btnReset, &QPushButton::clicked, this, &CheckListing::resetAll);
   actionLayout->addWidget(btnReset);
 
+  m_btnBatch = new QPushButton("📚 BATCH EVENTS");
+  m_btnBatch->setFixedHeight(50);
+  m_btnBatch->setFixedWidth(200);
+  m_btnBatch->setObjectName("infoButton");
+  m_btnBatch->setToolTip("Calculate and allocate several event folders with "
+                         "this listing table");
+  connect(m_btnBatch, &QPushButton::clicked, this, &CheckListing::onBatch);
+  actionLayout->addWidget(m_btnBatch);
+
+  m_chkMinimizeSplits = new QCheckBox("Minimize splits");
+  m_chkMinimizeSplits->setToolTip(
+      "Search for the allocation with the fewest split listings "
+      "(up to 50 ms per sector)");
+  m_chkMinimizeSplits->setStyleSheet("font-size: 15px; color: #AAB;");
+  actionLayout->addWidget(m_chkMinimizeSplits);
+
   actionLayout->addStretch();
   mainLayout->addWidget(actionBar);
 }
@@ -237,35 +278,44 @@ QWidget *CheckListing::createSectionLabel(const QString &text) {
 }
 
 void CheckListing::addRow() {
-  RowWidgets row;
-  row.container = new QWidget();
-  QHBoxLayout *l = new QHBoxLayout(row.container);
-  l->setContentsMargins(5, 2, 5, 2);
-  l->setSpacing(5);
-
-  auto createEdit = [&](int w, const QString &c) {
-    QLineEdit *e = new QLineEdit();
-    e->setFixedWidth(w);
-    e->setFixedHeight(35);
-    e->setAlignment(Qt::AlignCenter);
-    e->setStyleSheet(QString("background-color: #0d0d0d; color: %1; border: "
-                             "none; border-radius: 4px;")
-                         .arg(c));
-    return e;
-  };
+  m_listingModel->appendRows(1);
+  QModelIndex sector = m_listingModel->index(
+      m_listingModel->rowCount() - 1, ListingTableModel::SectorColumn);
+  m_listingView->scrollTo(sector);
+  m_listingView->setCurrentIndex(sector);
+}
 
-  row.sector = createEdit(100, "white");
-  row.gogo = createEdit(180, "#38bdf8");
-  row.net = createEdit(180, "#fb7185");
-  row.tix = createEdit(180, "#fbbf24");
+ListingEngine::ImportResult
+CheckListing::applyImports(const ListingEngine::Imports &in) {
+  if (!m_sectorDbLoaded) {
+    m_sectorResolver.loadSectorDB();
+    m_sectorDbLoaded = true;
+  }
+  QString context = SectorResolver::detectStadiumContext(m_stockModel.name);
+  return m_listingModel->applyImports(
+      in, ListingEngine::sectorAliases(m_sectorResolver, context));
+}
 
-  l->addWidget(row.sector);
-  l->addWidget(row.gogo);
-  l->addWidget(row.net);
-  l->addWidget(row.tix);
+QString
+CheckListing::unmatchedSummary(const ListingEngine::ImportResult &result) {
+  auto shortList = [](const QStringList &names) {
+    const int shown = 20;
+    QString text = names.mid(0, shown).join(", ");
+    if (names.size() > shown)
+      text += QString(" ... (+%1)").arg(names.size() - shown);
+    return text;
+  };
 
-  m_unifiedRows.append(row);
-  m_rowsLayout->insertWidget(m_rowsLayout->count() - 1, row.container);
+  QString text;
+  if (!result.unmatchedImported.isEmpty())
+    text += QString("\n\nNot in your list (%1): %2")
+                .arg(result.unmatchedImported.size())
+                .arg(shortList(result.unmatchedImported));
+  if (!result.unmatchedRows.isEmpty())
+    text += QString("\n\nNothing imported for (%1): %2")
+                .arg(result.unmatchedRows.size())
+                .arg(shortList(result.unmatchedRows));
+  return text;
 }
 
 void CheckListing::onImportGogo() {
@@ -274,84 +324,21 @@ void CheckListing::onImportGogo() {
   if (fileName.isEmpty())
     return;
 
-  QFile file(fileName);
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+  // Scanned straight from the mapped file; pages run to tens of MB
+  int foundRows = 0;
+  QString error;
+  QMap<QString, QString> importedData =
+      ListingEngine::parseGogoFile(fileName, &foundRows, &error);
+  if (!error.isEmpty()) {
     QMessageBox::critical(this, "Error", "Could not open file.");
     return;
   }
 
-  QString htmlContent = file.readAll();
-  file.close();
-
-  // Regex to extract Sector and Available Quantity
-  // Sector: <div class="t xs absl t0 w100 ellip">SECTOR</div>
-  // Qty: data-edit-field="AvailableTickets">...<span>QTY</span>
-
-  QMap<QString, QString> importedData;
-
-  // We parsed the HTML structure:
-  // 1. Find sector div
-  // 2. Look ahead for quantity span
-
-  // Revised Strategy (v4):
-  // HTML structure analysis reveals:
-  // <tr ... data-quantity="8"> ... <div class="t xs absl t0 w100
-  // ellip">157</div> ... We use data-quantity as the row anchor, then find the
-  // sector immediately following it.
-
-  // 1. Find all rows with quantity
-  QRegularExpression rowAnchorRe("data-quantity=\"(\\d+)\"");
-  QRegularExpression sectorRe(
-      "class=\"t xs absl t0 w100 ellip\">\\s*([^<]+)\\s*</div>");
-
-  auto rowMatch = rowAnchorRe.globalMatch(htmlContent);
-  int foundRows = 0;
-
-  while (rowMatch.hasNext()) {
-    auto rMatch = rowMatch.next();
-    QString qtyStr = rMatch.captured(1);
-
-    // Search for sector immediately after this row definition
-    int searchStart = rMatch.capturedEnd();
-    auto secMatch = sectorRe.match(htmlContent, searchStart);
-
-    // Sanity check: Sector must be reasonably close (within 1000 chars)
-    // and finding it shouldn't jump over another row anchor match (heuristic)
-    if (secMatch.hasMatch() &&
-        (secMatch.capturedStart() - searchStart < 2000)) {
-      QString sector = secMatch.captured(1).trimmed();
-      // Clean up sector text if needed (sometimes invisible chars)
-      sector.remove(QRegularExpression("[\\n\\r\\t]"));
-
-      if (!sector.isEmpty()) {
-        if (importedData.contains(sector))
-          importedData[sector] += " + " + qtyStr;
-        else
-          importedData[sector] = qtyStr;
-        foundRows++;
-      }
-    }
-  }
-
   // Update UI Rows
-  int updatedCount = 0;
-  for (auto &row : m_unifiedRows) {
-    QString currentSector = row.sector->text().trimmed();
-    // Try exact match first
-    if (importedData.contains(currentSector)) {
-      row.gogo->setText(importedData[currentSector]);
-      updatedCount++;
-    } else {
-      // Try case insensitive
-      for (auto it = importedData.begin(); it != importedData.end(); ++it) {
-        if (it.key().compare(currentSector, Qt::CaseInsensitive) == 0) {
-          row.gogo->setText(it.value());
-          updatedCount++;
-          break;
-        }
-      }
-    }
-  }
+  ListingEngine::Imports imports;
+  imports.gogo = importedData;
+  ListingEngine::ImportResult matched = applyImports(imports);
+  int updatedCount = matched.updatedRows;
 
   if (updatedCount == 0 && foundRows > 0) {
     QMessageBox::warning(
@@ -367,7 +354,8 @@ void CheckListing::onImportGogo() {
   if (updatedCount > 0) {
     QMessageBox::information(
         this, "Import Complete",
-        QString("Updated %1 rows from Gogo HTML.").arg(updatedCount));
+        QString("Updated %1 rows from Gogo HTML.").arg(updatedCount) +
+            unmatchedSummary(matched));
   } else if (foundRows == 0) {
     QMessageBox::warning(this, "Import Failed",
                          "Still could not find any rows. The website format "
@@ -386,52 +374,7 @@ void CheckListing::onImportTix() {
     return;
   }
 
-  QStringList lines = text.split('\n', Qt::SkipEmptyParts);
-
-  if (lines.isEmpty()) {
-    QMessageBox::warning(this, "Warning", "No data provided.");
-    return;
-  }
-
-  // Parse Tixstock Text Data
-  // Pattern based on your example:
-  // Line i: "E-ticket" (marker)
-  // Line i+1: Quantity (e.g., "2")
-  // Line i+2: "0"
-  // Line i+3: "All together"
-  // Line i+4-5: Numbers
-  // Line i+6: Sector name (e.g., "Terzo Anello Verde") - SKIP
-  // Line i+7: Block number (e.g., "358") - USE THIS
-
-  QMap<QString, QString> inventory;
-
-  for (int i = 0; i < lines.size(); ++i) {
-    QString line = lines[i].trimmed();
-
-    // Look for "E-ticket" marker
-    if (line == "E-ticket" && i + 7 < lines.size()) {
-      // Quantity is next line
-      bool ok;
-      int qty = lines[i + 1].trimmed().toInt(&ok);
-      if (!ok || qty <= 0)
-        continue;
-
-      // Block number is at i+7 (after: qty, 0, "All together", 2 numbers,
-      // sector name)
-      QString blockNum = lines[i + 7].trimmed();
-
-      // Use block number as the key (like "358", "324", etc.)
-      // Skip if it's "Row" or contains currency symbols
-      if (!blockNum.isEmpty() && blockNum != "Row" && !blockNum.contains("€") &&
-          !blockNum.contains("First")) {
-        if (inventory.contains(blockNum)) {
-          inventory[blockNum] += " + " + QString::number(qty);
-        } else {
-          inventory[blockNum] = QString::number(qty);
-        }
-      }
-    }
-  }
+  QMap<QString, QString> inventory = ListingEngine::parseTixText(text);
 
   if (inventory.isEmpty()) {
     QMessageBox::warning(
@@ -442,28 +385,16 @@ void CheckListing::onImportTix() {
   }
 
   // Update UI Rows
-  int updatedCount = 0;
-  for (int r = 0; r < m_unifiedRows.size(); ++r) {
-    QString currentSector = m_unifiedRows[r].sector->text().trimmed();
-    if (inventory.contains(currentSector)) {
-      m_unifiedRows[r].tix->setText(inventory[currentSector]);
-      updatedCount++;
-    } else {
-      // Case insensitive fallback
-      for (auto it = inventory.begin(); it != inventory.end(); ++it) {
-        if (it.key().compare(currentSector, Qt::CaseInsensitive) == 0) {
-          m_unifiedRows[r].tix->setText(it.value());
-          updatedCount++;
-          break;
-        }
-      }
-    }
-  }
+  ListingEngine::Imports imports;
+  imports.tix = inventory;
+  ListingEngine::ImportResult matched = applyImports(imports);
+  int updatedCount = matched.updatedRows;
 
   if (updatedCount > 0) {
     QMessageBox::information(
         this, "Import Complete",
-        QString("Updated %1 rows from TixStock data.").arg(updatedCount));
+        QString("Updated %1 rows from TixStock data.").arg(updatedCount) +
+            unmatchedSummary(matched));
   } else {
     QMessageBox::warning(this, "No Matches",
                          QString("Found %1 blocks in clipboard, but matched 0 "
@@ -476,250 +407,172 @@ void CheckListing::onImportTix() {
 void CheckListing::resetAll() {
   m_txtOriginal->clear();
   m_txtResult->clear();
-  for (auto &row : m_unifiedRows) {
-    row.sector->clear();
-    row.gogo->clear();
-    row.net->clear();
-    row.tix->clear();
-  }
+  m_listingModel->clearCells();
   m_lblGrand->setText("TOTAL LISTED: 0");
 }
 
-struct Demand {
-  QString platform;
-  int qty;
-  QString sector;
-};
-
-struct RowData {
-  QString sector;
-  int total;
-  int remaining;
-  QStringList allocs;
-  QString prefix;
-};
-
 void CheckListing::process() {
+  // The Generate button doubles as Cancel while a job runs
+  if (m_allocWatcher.isRunning()) {
+    m_allocWatcher.cancel();
+    m_btnGenerate->setText("⏳ CANCELLING...");
+    m_btnGenerate->setEnabled(false);
+    return;
+  }
+
   // Security Check
   SecurityManager::instance().checkAndAct();
 
-  // Visual Feedback
-  QPushButton *btnGen = this->findChild<QPushButton *>("btnGenerate");
-  if (btnGen) {
-    btnGen->setText("⏳ PROCESSING...");
-    btnGen->setEnabled(false);
-    QApplication::processEvents();
-  }
-
   QString stockText = m_txtOriginal->toPlainText().trimmed();
-  if (stockText.isEmpty()) {
-    if (btnGen) {
-      btnGen->setText("🚀 GENERATE FINAL STOCK");
-      btnGen->setEnabled(true);
-    }
+  if (stockText.isEmpty())
     return;
-  }
 
-  QMap<QString, QMap<QString, QList<int>>> listings; // Platform -> Sector ->
-                                                     // List of Qties
-  QStringList platforms = {"GOGO", "NET", "TIXSTOCK"};
-  int grandSum = 0;
+  // Snapshot the table; edits made while the job runs do not affect it
+  QList<ListingRow> rows = m_listingModel->listingRows();
 
-  for (auto &row : m_unifiedRows) {
-    if (grandSum % 50 == 0)
-      QApplication::processEvents(); // Keep UI alive
+  ListingEngine::AllocationOptions options;
+  options.minimizeSplits = m_chkMinimizeSplits->isChecked();
 
-    QString sec = row.sector->text().trimmed().toUpper();
-    if (sec.isEmpty())
-      continue;
+  m_allocWatcher.setFuture(
+      (!m_stockModelText.isEmpty() && stockText == m_stockModelText)
+          ? ListingEngine::allocateAsync(m_stockModel, rows, options)
+          : ListingEngine::allocateAsync(stockText, rows, options));
 
-    auto parseAndAdd = [&](const QString &plat, QLineEdit *edit) {
-      QString val = edit->text().trimmed();
-      if (val.isEmpty())
-        return;
-      QRegularExpression re("\\d+");
-      auto it = re.globalMatch(val);
-      while (it.hasNext()) {
-        int q = it.next().captured(0).toInt();
-        listings[plat][sec].append(q);
-        grandSum += q;
-      }
-    };
-
-    parseAndAdd("GOGO", row.gogo);
-    parseAndAdd("NET", row.net);
-    parseAndAdd("TIXSTOCK", row.tix);
-  }
+  m_btnGenerate->setText("⛔ CANCEL");
+}
 
-  m_lblGrand->setText(QString("TOTAL LISTED: %1").arg(grandSum));
-
-  // Parse Stock Text
-  QRegularExpression rowRe("(.*Row:.*?Qty:\\s*(\\d+)\\s*)\\[(.*?)\\]",
-                           QRegularExpression::CaseInsensitiveOption);
-  QRegularExpression secRe("Sector:\\s*([A-Za-z0-9]+)",
-                           QRegularExpression::CaseInsensitiveOption);
-
-  QStringList lines = stockText.split('\n');
-  QMap<int, RowData> rowMap;
-  QMap<QString, int> secCap;
-  QString currSec;
-
-  for (int i = 0; i < lines.size(); ++i) {
-    auto mSec = secRe.match(lines[i]);
-    if (mSec.hasMatch()) {
-      currSec = mSec.captured(1).toUpper();
-      if (!secCap.contains(currSec))
-        secCap[currSec] = 0;
-    }
-
-    auto mRow = rowRe.match(lines[i]);
-    if (mRow.hasMatch() && !currSec.isEmpty()) {
-      int qty = mRow.captured(2).toInt();
-      secCap[currSec] += qty;
-      rowMap[i] = {currSec, qty, qty, {}, mRow.captured(1)};
-    }
-  }
+void CheckListing::onAllocProgress(int value) {
+  int max = m_allocWatcher.progressMaximum();
+  if (max > 0 && !m_allocWatcher.isCanceled())
+    m_btnGenerate->setText(
+        QString("⛔ CANCEL (%1%)").arg(value * 100 / max));
+}
 
-  // Danger Check
-  QStringList danger;
-  QSet<QString> allSectors;
-  for (const auto &p : platforms)
-    for (const auto &s : listings[p].keys())
-      allSectors.insert(s);
-
-  for (const QString &s : allSectors) {
-    int totNeeded = 0;
-    for (const auto &p : platforms)
-      for (int q : listings[p][s])
-        totNeeded += q;
-    int avail = secCap.value(s, 0);
-    if (totNeeded > avail) {
-      danger.append(QString("Sector %1: %2 listed vs %3 available")
-                        .arg(s)
-                        .arg(totNeeded)
-                        .arg(avail));
-    }
-  }
+void CheckListing::onAllocFinished() {
+  m_btnGenerate->setText("🚀 GENERATE FINAL STOCK");
+  m_btnGenerate->setEnabled(true);
 
-  // Danger Check - REMOVED POPUP
-  if (!danger.isEmpty()) {
-    // Show error inline instead of popup
-    m_txtResult->setPlainText("⚠️ STOP! INSUFFICIENT STOCK - PLEASE "
-                              "FIX:\n\n" +
-                              danger.join('\n'));
-    if (this->findChild<QPushButton *>("btnGenerate")) {
-      auto btn = this->findChild<QPushButton *>("btnGenerate");
-      btn->setText("🚀 GENERATE FINAL STOCK");
-      btn->setEnabled(true);
-    }
+  if (m_allocWatcher.isCanceled() || m_allocWatcher.resultCount() == 0)
+    return; // Cancelled: the previous result stays as it was
+
+  // Applied in one go once the job is done
+  ListingEngine::AllocationResult result = m_allocWatcher.result();
+
+  m_lblGrand->setText(QString("TOTAL LISTED: %1").arg(result.grandTotal));
+
+  // Danger and missing stock are shown inline instead of popups
+  m_txtResult->setPlainText(ListingEngine::formatResult(result));
+}
+
+void CheckListing::onBatch() {
+  // Same button cancels a running batch
+  if (m_batchWatcher.isRunning()) {
+    m_batchWatcher.cancel();
+    m_btnBatch->setText("⏳ CANCELLING...");
+    m_btnBatch->setEnabled(false);
     return;
   }
 
-  // Allocation Logic ... (No changes here, just
-  // context if needed, but we scroll down)
-  // ...
-
-  // Allocation Logic
-  QList<Demand> demands;
-  for (const auto &p : platforms) {
-    for (auto it = listings[p].begin(); it != listings[p].end(); ++it) {
-      for (int q : it.value())
-        demands.append({p, q, it.key()});
-    }
-  }
+  QString parent = QFileDialog::getExistingDirectory(
+      this, "Select the folder containing the event folders");
+  if (parent.isEmpty())
+    return;
 
-  // Pass 1: Exact Match
-  for (auto &d : demands) {
-    for (auto &r : rowMap) {
-      if (r.sector == d.sector && r.remaining == d.qty) {
-        r.allocs.append(QString("X%1 %2").arg(d.qty).arg(d.platform));
-        r.remaining = 0;
-        d.qty = 0;
-        break;
-      }
-    }
+  // Every subfolder with a "- Tickets -" folder is an event
+  QStringList events;
+  const QStringList subdirs =
+      QDir(parent).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+  for (const QString &dir : subdirs) {
+    QString path = parent + "/" + dir;
+    if (QDir(path + "/- Tickets -").exists())
+      events.append(path);
+  }
+  if (events.isEmpty()) {
+    QMessageBox::warning(this, "Batch",
+                         "No event folders with a '- Tickets -' folder "
+                         "found there.");
+    return;
   }
 
-  // Pass 2: Best Fit (Fits in one row)
-  for (auto &d : demands) {
-    if (d.qty <= 0)
-      continue;
-    for (auto &r : rowMap) {
-      if (r.sector == d.sector && r.remaining >= d.qty) {
-        r.allocs.append(QString("X%1 %2").arg(d.qty).arg(d.platform));
-        r.remaining -= d.qty;
-        d.qty = 0;
-        break;
-      }
-    }
-  }
+  if (QMessageBox::question(
+          this, "Batch",
+          QString("Allocate the current listing table on %1 events?\n\n%2")
+              .arg(events.size())
+              .arg(QStringList(events.mid(0, 20))
+                       .replaceInStrings(parent + "/", "")
+                       .join("\n"))) != QMessageBox::Yes)
+    return;
 
-  // Pass 3: Fractional (Split)
-  for (auto &d : demands) {
-    if (d.qty <= 0)
-      continue;
-    for (auto &r : rowMap) {
-      if (r.sector == d.sector && r.remaining > 0) {
-        int take = qMin(d.qty, r.remaining);
-        r.allocs.append(QString("X%1 %2").arg(take).arg(d.platform));
-        r.remaining -= take;
-        d.qty -= take;
-        if (d.qty <= 0)
-          break;
-      }
-    }
-  }
+  ListingEngine::AllocationOptions options;
+  options.minimizeSplits = m_chkMinimizeSplits->isChecked();
+  m_batchEvents.clear();
+  m_batchWatcher.setFuture(ListingEngine::allocateEvents(
+      events, m_listingModel->listingRows(), options));
+  m_btnBatch->setText(QString("⛔ CANCEL (0/%1)").arg(events.size()));
+}
 
-  // Final Assembly
-  QStringList resultLines;
-  QStringList missingStock; // To track under-listing
-
-  for (int i = 0; i < lines.size(); ++i) {
-    if (rowMap.contains(i)) {
-      RowData &r = rowMap[i];
-      if (!r.allocs.isEmpty()) {
-        QString allocStr = r.allocs.join(" / ");
-        QString stillStr = "";
-
-        if (r.remaining > 0) {
-          stillStr = QString(" STILL X%1").arg(r.remaining);
-          missingStock.append(
-              QString("Sector %1: Missing X%2").arg(r.sector).arg(r.remaining));
-        }
-
-        resultLines.append(
-            QString("%1[%2]%3").arg(r.prefix, allocStr, stillStr));
-      } else {
-        // No allocations but we have this row
-        // mapped? Means we have stock but 0
-        // allocated.
-        if (r.total > 0) {
-          missingStock.append(QString("Sector %1: 100% Missing (X%2)")
-                                  .arg(r.sector)
-                                  .arg(r.total));
-        }
-        resultLines.append(lines[i]);
-      }
-    } else {
-      resultLines.append(lines[i]);
-    }
-  }
+void CheckListing::onBatchProgress(int value) {
+  if (!m_batchWatcher.isCanceled())
+    m_btnBatch->setText(QString("⛔ CANCEL (%1/%2)")
+                            .arg(value)
+                            .arg(m_batchWatcher.progressMaximum()));
+}
 
-  m_txtResult->setPlainText(resultLines.join('\n'));
+void CheckListing::onBatchResult(int index) {
+  QFuture<ListingEngine::EventAllocation> future = m_batchWatcher.future();
+  if (future.isResultReadyAt(index))
+    m_batchEvents.insert(index, future.resultAt(index));
+}
 
-  // Restore Button
-  if (btnGen) {
-    btnGen->setText("🚀 GENERATE FINAL STOCK");
-    btnGen->setEnabled(true);
-  }
+void CheckListing::onBatchFinished() {
+  m_btnBatch->setText("📚 BATCH EVENTS");
+  m_btnBatch->setEnabled(true);
 
-  // MISSING STOCK WARNING - REMOVED POPUP
-  if (!missingStock.isEmpty()) {
-    QString msg = "\n\n⚠️ WARNING: MISSING ITEMS - YOU HAVE "
-                  "NOT LISTED EVERYTHING:\n";
-    msg += missingStock.join('\n');
-    m_txtResult->append(msg);
-  }
+  // A cancelled batch still reports the events that were done
+  QList<ListingEngine::EventAllocation> events = m_batchEvents.values();
+  if (events.isEmpty())
+    return;
+
+  QString desktop =
+      QStandardPaths::writableLocation(QStandardPaths::DesktopLocation);
+  QString stockFolder = desktop + "/Stock Files";
+  QDir().mkpath(stockFolder);
+
+  auto writeFile = [](const QString &path, const QString &text) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+      return false;
+    QTextStream out(&file);
+    out.setEncoding(QStringConverter::Utf8);
+    out << text;
+    return true;
+  };
+
+  QStringList failed;
+  for (const auto &e : events) {
+    if (!e.error.isEmpty())
+      continue;
+    QString safeName = e.name;
+    safeName.remove(QRegularExpression(R"([\\/*?:"<>|])"));
+    QString file = QString("%1/Final_Stock_%2.txt").arg(stockFolder, safeName);
+    if (!writeFile(file, ListingEngine::formatResult(e.result)))
+      failed.append(file);
+  }
+
+  QString summary = ListingEngine::batchSummary(events);
+  if (m_batchWatcher.isCanceled())
+    summary += "\n(cancelled before the remaining events)";
+  QString summaryFile =
+      QString("%1/Batch_Summary_%2.txt")
+          .arg(stockFolder,
+               QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+  if (!writeFile(summaryFile, summary))
+    failed.append(summaryFile);
+
+  summary += QString("\n\nResults saved to: %1").arg(stockFolder);
+  if (!failed.isEmpty())
+    summary += "\n❌ Could not write:\n" + failed.join('\n');
+  m_txtResult->setPlainText(summary);
 }
 
 void CheckListing::onCalcStock() {
@@ -740,8 +593,8 @@ void CheckListing::onCalcStock() {
   }
 
   // 3. Start Background Thread
-  QFuture<QString> future = QtConcurrent::run([path, oddEven]() {
-    return CalcStock::generateReportContent(path, oddEven);
+  QFuture<StockModel::Event> future = QtConcurrent::run([path, oddEven]() {
+    return StockManifest::generateModel(path, oddEven);
   });
 
   m_calcWatcher.setFuture(future);
@@ -755,10 +608,11 @@ void CheckListing::onCalcFinished() {
   }
 
   // 2. Get Result
-  QString report = m_calcWatcher.result();
+  StockModel::Event stock = m_calcWatcher.result();
 
   // 3. Check Error
-  if (report == "ERROR_NO_TICKETS_FOLDER") {
+  if (stock.error == StockEngine::ERROR_NO_TICKETS_FOLDER) {
+    m_stockModelText.clear();
     m_txtOriginal->setPlainText("❌ Error: Could not find '- Tickets -' "
                                 "folder.\nPlease select the "
                                 "main event folder.");
@@ -766,56 +620,14 @@ void CheckListing::onCalcFinished() {
   }
 
   // 4. Populate
+  m_stockModel = stock;
+  QString report = StockModel::render(stock);
   m_txtOriginal->setPlainText(report);
+  m_stockModelText = m_txtOriginal->toPlainText().trimmed();
 
   // --- Auto-fill Sectors in Table ---
-  QStringList sectors;
-  QRegularExpression secRe("Sector:\\s*([^\\s]+)",
-                           QRegularExpression::CaseInsensitiveOption);
-
-  QStringList lines = report.split('\n');
-  for (const QString &line : lines) {
-    if (line.contains("Sector:", Qt::CaseInsensitive)) {
-      auto match = secRe.match(line);
-      if (match.hasMatch()) {
-        sectors.append(match.captured(1).trimmed());
-      }
-    }
-  }
-
-  // Remove duplicate sectors
-  sectors.removeDuplicates();
-
-  // Optimize UI updates
-  m_rowsLayout->parentWidget()->setUpdatesEnabled(false);
-
-  // Ensure enough rows
-  while (m_unifiedRows.size() < sectors.size()) {
-    addRow();
-    if (m_unifiedRows.size() % 10 == 0) {
-      QApplication::processEvents(); // Keep UI responsive
-                                     // during heavy creation
-    }
-  }
-
-  // Fill rows
-  for (int i = 0; i < m_unifiedRows.size(); ++i) {
-    if (i < sectors.size()) {
-      m_unifiedRows[i].sector->setText(sectors[i]);
-    } else {
-      m_unifiedRows[i].sector->clear();
-    }
-
-    if (i % 50 == 0) {
-      QApplication::processEvents(); // Keep UI responsive
-                                     // during population
-    }
-  }
-
-  m_rowsLayout->parentWidget()->setUpdatesEnabled(true);
-
-  // Force final repaint
-  QApplication::processEvents();
+  // One model reset, however many sectors the stadium has
+  m_listingModel->setSectors(StockModel::sectorNames(stock));
 }
 
 void CheckListing::onImportNet() {
@@ -825,82 +637,24 @@ void CheckListing::onImportNet() {
   if (fileName.isEmpty())
     return;
 
-  QFile file(fileName);
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+  QString error;
+  QMap<QString, QString> importedData =
+      ListingEngine::parseNetFile(fileName, &error);
+  if (!error.isEmpty()) {
     QMessageBox::critical(this, "Error", "Could not open file.");
     return;
   }
 
-  QString htmlContent = file.readAll();
-  file.close();
-
-  QMap<QString, QString> importedData;
-  int pos = 0;
-
-  // Strategy: Find class="quantity", extract value,
-  // then find data-block in subsequent edit_ticket
-  while ((pos = htmlContent.indexOf("class=\"quantity\"", pos)) != -1) {
-    // Find quantity value
-    int qtyStart = htmlContent.indexOf("class=\"quantity_value\">", pos);
-    if (qtyStart == -1) {
-      pos += 1;
-      continue;
-    }
-    qtyStart += 23;
-    int qtyEnd = htmlContent.indexOf("<", qtyStart);
-    if (qtyEnd == -1)
-      break;
-    QString qty = htmlContent.mid(qtyStart, qtyEnd - qtyStart).trimmed();
-
-    // Find sector (block) in subsequent Action Row
-    // -> Edit Ticket data values
-    int editStart = htmlContent.indexOf("class=\"edit_ticket", qtyEnd);
-
-    // Safety: Ensure it's reasonably close (e.g.
-    // within 2000 chars) to assume same row
-    if (editStart != -1 && (editStart - qtyEnd < 2000)) {
-      int blockRef = htmlContent.indexOf("data-block=\"", editStart);
-      if (blockRef != -1) {
-        blockRef += 12;
-        int blockEnd = htmlContent.indexOf("\"", blockRef);
-        if (blockEnd != -1) {
-          QString sector =
-              htmlContent.mid(blockRef, blockEnd - blockRef).trimmed();
-
-          if (!sector.isEmpty() && !qty.isEmpty()) {
-            if (importedData.contains(sector)) {
-              importedData[sector] += " + " + qty;
-            } else {
-              importedData[sector] = qty;
-            }
-          }
-        }
-      }
-    }
-    pos = qtyEnd;
-  }
-
-  int updatedCount = 0;
-  for (auto &row : m_unifiedRows) {
-    QString currentSector = row.sector->text().trimmed();
-    if (importedData.contains(currentSector)) {
-      row.net->setText(importedData[currentSector]);
-      updatedCount++;
-    } else {
-      for (auto it = importedData.begin(); it != importedData.end(); ++it) {
-        if (it.key().compare(currentSector, Qt::CaseInsensitive) == 0) {
-          row.net->setText(it.value());
-          updatedCount++;
-          break;
-        }
-      }
-    }
-  }
+  ListingEngine::Imports imports;
+  imports.net = importedData;
+  ListingEngine::ImportResult matched = applyImports(imports);
+  int updatedCount = matched.updatedRows;
 
   if (updatedCount > 0) {
     QMessageBox::information(
         this, "Import Complete",
-        QString("Updated %1 rows from Net HTML.").arg(updatedCount));
+        QString("Updated %1 rows from Net HTML.").arg(updatedCount) +
+            unmatchedSummary(matched));
   } else {
     QMessageBox::warning(this, "Import Failed",
                          QString("Found %1 blocks in HTML, but matched 0 with "
@@ -1,30 +1,30 @@
 #ifndef CHECKLISTING_H
 #define CHECKLISTING_H
 
+#include <QCheckBox>
 #include <QDialog>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QLabel>
-#include <QLineEdit>
 #include <QList>
+#include <QMap>
 #include <QProgressDialog>
 #include <QPushButton>
 #include <QString>
 #include <QStringList>
+#include <QTableView>
 #include <QTextEdit>
 #include <QVBoxLayout>
 
 #include <QRegularExpression>
 
+#include "../core/ListingEngine.h"
+#include "../core/SectorResolver.h"
+#include "../core/StockModel.h"
+
 namespace GOL {
 
-struct RowWidgets {
-  QWidget *container;
-  QLineEdit *sector;
-  QLineEdit *gogo;
-  QLineEdit *net;
-  QLineEdit *tix;
-};
+class ListingTableModel;
 
 class CheckListing : public QDialog {
   Q_OBJECT
@@ -40,23 +40,48 @@ private slots:
   void onImportGogo();
   void onImportTix();
   void onImportNet();
+  void onBatch();
 
 private:
   void setupUI();
 
   QTextEdit *m_txtOriginal;
   QTextEdit *m_txtResult;
-  QVBoxLayout *m_rowsLayout;
-  QList<RowWidgets> m_unifiedRows;
+  ListingTableModel *m_listingModel;
+  QTableView *m_listingView;
   QLabel *m_lblGrand;
 
   // UI Helpers
   QWidget *createSectionLabel(const QString &text);
 
+  // Imports go through one sector index, with sector_db.json aliases for
+  // the stadium of the calculated event
+  ListingEngine::ImportResult applyImports(const ListingEngine::Imports &in);
+  static QString unmatchedSummary(const ListingEngine::ImportResult &result);
+  SectorResolver m_sectorResolver;
+  bool m_sectorDbLoaded = false;
+
   // Background Processing
   void onCalcFinished();
-  QFutureWatcher<QString> m_calcWatcher;
+  QFutureWatcher<StockModel::Event> m_calcWatcher;
+  void onAllocFinished();
+  void onAllocProgress(int value);
+  QFutureWatcher<ListingEngine::AllocationResult> m_allocWatcher;
+  void onBatchFinished();
+  void onBatchProgress(int value);
+  void onBatchResult(int index);
+  QFutureWatcher<ListingEngine::EventAllocation> m_batchWatcher;
+  // Finished events by position; a cancelled future drops its results
+  QMap<int, ListingEngine::EventAllocation> m_batchEvents;
+
+  // Last calculated stock and its text; allocation uses the model as long
+  // as the "original stock" box still holds that text
+  StockModel::Event m_stockModel;
+  QString m_stockModelText;
   QPushButton *m_btnCalc = nullptr;
+  QPushButton *m_btnGenerate = nullptr;
+  QPushButton *m_btnBatch = nullptr;
+  QCheckBox *m_chkMinimizeSplits = nullptr;
 };
 
 } // namespace GOL
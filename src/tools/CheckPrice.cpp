@@ -1,19 +1,22 @@
 #include "../SecurityManager.h"
 #include "../Utils.h"
+#include "../core/PriceHistory.h"
+#include "../core/StockManifest.h"
 #include "CheckPrice.h"
 #include <QApplication>
 #include <QClipboard>
+#include <QDateTime>
+#include <QDir>
 #include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QLabel>
-#include <QMap>
 #include <QMessageBox>
-#include <QRegularExpression>
 #include <QTextStream>
 #include <QVBoxLayout>
-#include <algorithm>
+#include <QtConcurrent/QtConcurrent>
 
 
 namespace GOL {
@@ -116,6 +119,38 @@ CheckPrice::CheckPrice(QWidget *parent) : QDialog(parent) {
   file2Layout->addWidget(m_btnBrowse2);
   mainLayout->addWidget(file2Group);
 
+  // Event folder: face-value floor of the suggested prices, and the event
+  // the price history is saved under
+  QGroupBox *stockGroup =
+      new QGroupBox("Event Folder (Optional - FV Floor and Price History)");
+  stockGroup->setStyleSheet(
+      QString("QGroupBox { color: white; border: 1px solid %1; "
+              "border-radius: 8px; padding: 15px; margin-top: 10px; }"
+              "QGroupBox::title { subcontrol-origin: margin; left: 10px; }")
+          .arg(Utils::CARD_BORDER));
+  QHBoxLayout *stockLayout = new QHBoxLayout(stockGroup);
+
+  m_stockPath = new QLineEdit();
+  m_stockPath->setPlaceholderText(
+      "No event loaded - no price floor, no price history");
+  m_stockPath->setReadOnly(true);
+  m_stockPath->setStyleSheet("background-color: #333; color: white; padding: "
+                             "8px; border-radius: 5px;");
+
+  m_btnBrowseStock = new QPushButton("📁 Browse");
+  m_btnBrowseStock->setFixedHeight(40);
+  m_btnBrowseStock->setCursor(Qt::PointingHandCursor);
+  m_btnBrowseStock->setStyleSheet(
+      QString("QPushButton { background-color: %1; color: white; "
+              "border-radius: 8px; font-weight: bold; padding: 0 20px; }"
+              "QPushButton:hover { background-color: #1a5a8a; }"
+              "QPushButton:disabled { background-color: #555; }")
+          .arg(Utils::ACCENT_COLOR));
+
+  stockLayout->addWidget(m_stockPath);
+  stockLayout->addWidget(m_btnBrowseStock);
+  mainLayout->addWidget(stockGroup);
+
   // Filter Buttons
   QHBoxLayout *filterLayout = new QHBoxLayout();
 
@@ -139,6 +174,30 @@ CheckPrice::CheckPrice(QWidget *parent) : QDialog(parent) {
   filterLayout->addWidget(m_btnRightFilter);
   mainLayout->addLayout(filterLayout);
 
+  m_btnAllPlatforms = new QPushButton("🌐 ALL PLATFORMS BY SECTOR");
+  m_btnAllPlatforms->setFixedHeight(45);
+  m_btnAllPlatforms->setCursor(Qt::PointingHandCursor);
+  m_btnAllPlatforms->setStyleSheet(
+      QString("QPushButton { background-color: %1; color: white; "
+              "border-radius: 12px; font-weight: bold; font-size: 14px; }"
+              "QPushButton:hover { background-color: #1a5a8a; }")
+          .arg(Utils::ACCENT_COLOR));
+
+  m_btnBatch = new QPushButton("📂 BATCH FOLDER");
+  m_btnBatch->setFixedHeight(45);
+  m_btnBatch->setCursor(Qt::PointingHandCursor);
+  m_btnBatch->setStyleSheet(
+      QString("QPushButton { background-color: %1; color: white; "
+              "border-radius: 12px; font-weight: bold; font-size: 14px; }"
+              "QPushButton:hover { background-color: #1a5a8a; }"
+              "QPushButton:disabled { background-color: #555; }")
+          .arg(Utils::ACCENT_COLOR));
+
+  QHBoxLayout *multiLayout = new QHBoxLayout();
+  multiLayout->addWidget(m_btnAllPlatforms);
+  multiLayout->addWidget(m_btnBatch);
+  mainLayout->addLayout(multiLayout);
+
   // Results area
   m_resultArea = new QTextEdit();
   m_resultArea->setReadOnly(true);
@@ -159,6 +218,14 @@ CheckPrice::CheckPrice(QWidget *parent) : QDialog(parent) {
                            "black; border-radius: 8px; font-weight: bold; }"
                            "QPushButton:hover { background-color: #059669; }");
 
+  m_btnExport = new QPushButton("💾 EXPORT REPRICING");
+  m_btnExport->setFixedHeight(45);
+  m_btnExport->setCursor(Qt::PointingHandCursor);
+  m_btnExport->setStyleSheet(
+      "QPushButton { background-color: #f59e0b; color: black; "
+      "border-radius: 8px; font-weight: bold; }"
+      "QPushButton:hover { background-color: #d97706; }");
+
   m_btnClear = new QPushButton("🗑️ CLEAR");
   m_btnClear->setFixedHeight(45);
   m_btnClear->setCursor(Qt::PointingHandCursor);
@@ -167,6 +234,7 @@ CheckPrice::CheckPrice(QWidget *parent) : QDialog(parent) {
                             "QPushButton:hover { background-color: #e11d48; }");
 
   footerLayout->addWidget(m_btnCopy);
+  footerLayout->addWidget(m_btnExport);
   footerLayout->addWidget(m_btnClear);
   mainLayout->addLayout(footerLayout);
 
@@ -180,7 +248,22 @@ CheckPrice::CheckPrice(QWidget *parent) : QDialog(parent) {
           &CheckPrice::runLeftFilter);
   connect(m_btnRightFilter, &QPushButton::clicked, this,
           &CheckPrice::runRightFilter);
+  connect(m_btnAllPlatforms, &QPushButton::clicked, this,
+          &CheckPrice::runAllPlatforms);
+  connect(m_btnBatch, &QPushButton::clicked, this, &CheckPrice::onBatch);
+  connect(&m_batchWatcher, &QFutureWatcher<PageCheck>::progressValueChanged,
+          this, &CheckPrice::onBatchProgress);
+  connect(&m_batchWatcher, &QFutureWatcher<PageCheck>::resultReadyAt, this,
+          &CheckPrice::onBatchResult);
+  connect(&m_batchWatcher, &QFutureWatcher<PageCheck>::finished, this,
+          &CheckPrice::onBatchFinished);
+  connect(m_btnBrowseStock, &QPushButton::clicked, this,
+          &CheckPrice::browseStock);
+  connect(&m_stockWatcher, &QFutureWatcher<StockModel::Event>::finished, this,
+          &CheckPrice::onStockLoaded);
   connect(m_btnCopy, &QPushButton::clicked, this, &CheckPrice::copyToClipboard);
+  connect(m_btnExport, &QPushButton::clicked, this,
+          &CheckPrice::exportRepricing);
   connect(m_btnClear, &QPushButton::clicked, this, &CheckPrice::clearAll);
 
   // Initialize state
@@ -218,52 +301,54 @@ void CheckPrice::browseFile2() {
   }
 }
 
-void CheckPrice::runLeftFilter() {
+void CheckPrice::browseStock() {
   SecurityManager::instance().checkAndAct();
 
-  QString file1 = m_file1Path->text();
-  if (file1.isEmpty()) {
-    QMessageBox::warning(this, "Error", "Please select HTML File 1 first.");
+  QString path = QFileDialog::getExistingDirectory(
+      this, "Select Event Folder (face values and price history)");
+  if (path.isEmpty() || m_stockWatcher.isRunning())
     return;
-  }
-
-  if (m_currentPlatform == Platform::TIXSTOCK) {
-    QString file2 = m_file2Path->text();
-    if (file2.isEmpty()) {
-      QMessageBox::warning(
-          this, "Error",
-          "Tixstock requires both HTML files (My Listings + All Listings).");
-      return;
-    }
-  }
 
-  m_currentMode = CompareMode::LEFT_FILTER;
+  m_stockPath->setText("Loading " + QFileInfo(path).fileName() + "...");
+  m_btnBrowseStock->setEnabled(false);
+  m_stockWatcher.setFuture(QtConcurrent::run(
+      [path]() { return StockManifest::generateModel(path, false); }));
+}
 
-  QFile f1(file1);
-  if (!f1.open(QIODevice::ReadOnly | QIODevice::Text)) {
-    QMessageBox::critical(this, "Error", "Could not open File 1.");
+void CheckPrice::onStockLoaded() {
+  m_btnBrowseStock->setEnabled(true);
+  StockModel::Event stock = m_stockWatcher.result();
+  if (!stock.error.isEmpty()) {
+    m_stock = StockModel::Event();
+    m_stockPath->clear();
+    QMessageBox::warning(this, "Error",
+                         "No '- Tickets -' folder found in this event.");
     return;
   }
-  QString html1 = QTextStream(&f1).readAll();
-  f1.close();
+  m_stock = stock;
+  m_stockPath->setText(stock.path);
+}
 
-  QString html2;
-  if (m_currentPlatform == Platform::TIXSTOCK) {
-    QFile f2(m_file2Path->text());
-    if (!f2.open(QIODevice::ReadOnly | QIODevice::Text)) {
-      QMessageBox::critical(this, "Error", "Could not open File 2.");
-      return;
-    }
-    html2 = QTextStream(&f2).readAll();
-    f2.close();
+PriceFloors CheckPrice::priceFloors(const QString &pagePath) {
+  if (m_stock.categories.isEmpty()) {
+    PriceFloors floors; // No floors, but sectors still resolve for history
+    floors.resolver = sectorResolver(pagePath);
+    return floors;
   }
+  return PriceEngine::faceValueFloors(m_stock, sectorResolver(pagePath));
+}
 
-  QString report =
-      generateReport(m_currentPlatform, m_currentMode, html1, html2);
-  m_resultArea->setText(report);
+void CheckPrice::runLeftFilter() {
+  m_currentMode = CompareMode::LEFT_FILTER;
+  runFilter();
 }
 
 void CheckPrice::runRightFilter() {
+  m_currentMode = CompareMode::RIGHT_FILTER;
+  runFilter();
+}
+
+void CheckPrice::runFilter() {
   SecurityManager::instance().checkAndAct();
 
   QString file1 = m_file1Path->text();
@@ -282,8 +367,6 @@ void CheckPrice::runRightFilter() {
     }
   }
 
-  m_currentMode = CompareMode::RIGHT_FILTER;
-
   QFile f1(file1);
   if (!f1.open(QIODevice::ReadOnly | QIODevice::Text)) {
     QMessageBox::critical(this, "Error", "Could not open File 1.");
@@ -303,322 +386,222 @@ void CheckPrice::runRightFilter() {
     f2.close();
   }
 
-  QString report =
-      generateReport(m_currentPlatform, m_currentMode, html1, html2);
-  m_resultArea->setText(report);
+  QString marketFile = m_currentPlatform == Platform::TIXSTOCK
+                           ? m_file2Path->text()
+                           : m_file1Path->text();
+  // One parse feeds both the report and the price history
+  QList<PriceRecord> records;
+  m_lastChecks =
+      PriceEngine::checkListings(m_currentPlatform, m_currentMode, html1,
+                                 html2, priceFloors(marketFile), &records);
+  m_lastPlatform = m_currentPlatform;
+  m_resultArea->setText(PriceEngine::formatReport(m_lastChecks));
+  recordHistory(records, {{m_currentPlatform, marketFile}});
 }
 
-void CheckPrice::clearAll() { m_resultArea->clear(); }
+void CheckPrice::runAllPlatforms() {
+  SecurityManager::instance().checkAndAct();
 
-void CheckPrice::copyToClipboard() {
-  QString text = m_resultArea->toPlainText();
-  if (!text.isEmpty()) {
-    QApplication::clipboard()->setText(text);
-    QMessageBox::information(this, "Success", "Report copied to clipboard!");
+  // One page per platform, Cancel skips it. marketFiles: the page holding
+  // each platform's market, whose save time stamps its history snapshot.
+  QMap<Platform, QString> marketFiles;
+  auto pick = [this](const QString &title, QString &html, QString &path) {
+    QString fileName = QFileDialog::getOpenFileName(this, title, "",
+                                                    "HTML Files (*.html)");
+    if (fileName.isEmpty())
+      return false;
+    QFile f(fileName);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      QMessageBox::critical(this, "Error", "Could not open " + fileName);
+      return false;
+    }
+    html = QTextStream(&f).readAll();
+    path = fileName;
+    return true;
+  };
+
+  QList<MarketSnapshot> snapshots;
+  QString path;
+  MarketSnapshot ftn;
+  ftn.platform = Platform::FTN;
+  if (pick("FTN Page (Cancel to skip)", ftn.html, path)) {
+    snapshots.append(ftn);
+    marketFiles.insert(Platform::FTN, path);
   }
-}
 
-double CheckPrice::cleanPrice(const QString &priceStr) {
-  if (priceStr.isEmpty())
-    return 0.0;
+  MarketSnapshot tix;
+  tix.platform = Platform::TIXSTOCK;
+  QString ownPath;
+  if (pick("Tixstock My Listings (Cancel to skip)", tix.html, ownPath) &&
+      pick("Tixstock All Listings", tix.marketHtml, path)) {
+    snapshots.append(tix);
+    marketFiles.insert(Platform::TIXSTOCK, path);
+  }
 
-  QString clean = priceStr;
-  clean.remove(QRegularExpression("[^\\d\\.,]"));
+  MarketSnapshot gogo;
+  gogo.platform = Platform::VIAGOGO;
+  if (pick("Viagogo Page (Cancel to skip)", gogo.html, path)) {
+    snapshots.append(gogo);
+    marketFiles.insert(Platform::VIAGOGO, path);
+  }
 
-  if (clean.contains(',') && !clean.contains('.')) {
-    clean.replace(',', '.');
+  if (snapshots.isEmpty()) {
+    QMessageBox::warning(this, "Error", "No HTML files selected.");
+    return;
   }
 
-  bool ok;
-  double val = clean.toDouble(&ok);
-  return ok ? val : 0.0;
+  QList<PriceRecord> records = PriceEngine::sectorRecords(
+      snapshots, sectorResolver(marketFiles.first()));
+  m_resultArea->setText(
+      PriceEngine::formatUnifiedView(PriceEngine::unifiedView(records)));
+  recordHistory(records, marketFiles);
 }
 
-QList<Listing> CheckPrice::parseFTNHtml(const QString &html) {
-  QList<Listing> listings;
-
-  QRegularExpression rowRegex(
-      "<div[^>]*class=\"[^\"]*stand_Sprice[^\"]*desktop[^\"]*\"[^>]*>(.*?)</"
-      "div>\\s*</div>\\s*</div>",
-      QRegularExpression::DotMatchesEverythingOption);
-
-  auto it = rowRegex.globalMatch(html);
-
-  while (it.hasNext()) {
-    auto match = it.next();
-    QString rowContent = match.captured(0);
-
-    Listing listing;
-    listing.isOwned = rowContent.contains("current_seller_ticket");
-
-    QRegularExpression catRegex(
-        "<div[^>]*class=\"[^\"]*category[^\"]*\"[^>]*>(.*?)</div>");
-    auto catMatch = catRegex.match(rowContent);
-    if (catMatch.hasMatch()) {
-      QString catText = catMatch.captured(1);
-      catText.remove(QRegularExpression("<[^>]*>"));
-      listing.category = catText.trimmed();
-    }
-
-    QRegularExpression blockRegex("Block:\\s*([^<\\n]+)");
-    auto blockMatch = blockRegex.match(rowContent);
-    if (blockMatch.hasMatch()) {
-      listing.block = blockMatch.captured(1).trimmed();
-    }
+void CheckPrice::onBatch() {
+  // Same button cancels a running batch
+  if (m_batchWatcher.isRunning()) {
+    m_batchWatcher.cancel();
+    m_btnBatch->setText("⏳ CANCELLING...");
+    m_btnBatch->setEnabled(false);
+    return;
+  }
 
-    QRegularExpression priceRegex("€\\s*([\\d,\\.]+)");
-    auto priceMatch = priceRegex.match(rowContent);
-    if (priceMatch.hasMatch()) {
-      listing.price = cleanPrice(priceMatch.captured(1));
-    }
+  SecurityManager::instance().checkAndAct();
 
-    QRegularExpression qtyRegex("Up To (\\d+) Seats");
-    auto qtyMatch = qtyRegex.match(rowContent);
-    if (qtyMatch.hasMatch()) {
-      listing.quantity = qtyMatch.captured(1).toInt();
-    } else {
-      listing.quantity = 1;
-    }
+  QString folder = QFileDialog::getExistingDirectory(
+      this, "Select the folder with the saved HTML pages");
+  if (folder.isEmpty())
+    return;
 
-    if (listing.price > 0) {
-      listings.append(listing);
-    }
+  QList<PageCheck> pages = PriceEngine::batchPages(folder);
+  if (pages.isEmpty()) {
+    QMessageBox::warning(this, "Batch", "No HTML pages found there.");
+    return;
   }
 
-  return listings;
+  // Every page uses the filter of the last run (LEFT by default)
+  m_batchPages.clear();
+  m_batchWatcher.setFuture(
+      PriceEngine::checkPages(pages, m_currentMode, priceFloors(folder)));
+  m_btnBatch->setText(QString("⛔ CANCEL (0/%1)").arg(pages.size()));
 }
 
-QList<Listing> CheckPrice::parseTixstockHtml(const QString &html) {
-  QList<Listing> listings;
-
-  QRegularExpression rowRegex("<tr[^>]*>(.*?)</tr>",
-                              QRegularExpression::DotMatchesEverythingOption);
-  auto it = rowRegex.globalMatch(html);
+void CheckPrice::onBatchProgress(int value) {
+  if (!m_batchWatcher.isCanceled())
+    m_btnBatch->setText(QString("⛔ CANCEL (%1/%2)")
+                            .arg(value)
+                            .arg(m_batchWatcher.progressMaximum()));
+}
 
-  while (it.hasNext()) {
-    auto match = it.next();
-    QString rowContent = match.captured(1);
+void CheckPrice::onBatchResult(int index) {
+  // Kept as they arrive: a cancelled future drops its stored results
+  QFuture<PageCheck> future = m_batchWatcher.future();
+  if (future.isResultReadyAt(index))
+    m_batchPages.insert(index, future.resultAt(index));
+}
 
-    if (rowContent.contains("Ticket Price") ||
-        rowContent.contains("Section/Block")) {
-      continue;
-    }
+void CheckPrice::onBatchFinished() {
+  m_btnBatch->setText("📂 BATCH FOLDER");
+  m_btnBatch->setEnabled(true);
 
-    QRegularExpression tdRegex("<td[^>]*>(.*?)</td>",
-                               QRegularExpression::DotMatchesEverythingOption);
-    auto tdIt = tdRegex.globalMatch(rowContent);
+  // A cancelled batch still reports the pages that were done
+  if (m_batchPages.isEmpty())
+    return;
 
-    QStringList cells;
-    while (tdIt.hasNext()) {
-      QString cell = tdIt.next().captured(1);
-      cell.remove(QRegularExpression("<[^>]*>"));
-      cells.append(cell.trimmed());
-    }
+  QString report = PriceEngine::batchReport(m_batchPages.values());
+  if (m_batchWatcher.isCanceled())
+    report += "\n(cancelled before the remaining pages)";
+  m_resultArea->setText(report);
 
-    if (cells.size() < 6)
+  for (const PageCheck &page : std::as_const(m_batchPages)) {
+    if (!page.error.isEmpty())
       continue;
-
-    Listing listing;
-    listing.quantity = cells[0].remove(QRegularExpression("\\D")).toInt();
-    listing.category = cells[1];
-    listing.section = cells[2];
-    listing.row = cells[3];
-    listing.price = cleanPrice(cells[5]);
-    listing.isOwned = false;
-
-    if (listing.price > 0) {
-      listings.append(listing);
-    }
+    QString marketFile =
+        page.marketPath.isEmpty() ? page.path : page.marketPath;
+    if (!recordHistory(page.records, {{page.platform, marketFile}}))
+      break;
   }
-
-  return listings;
 }
 
-QList<Listing> CheckPrice::parseViagogoHtml(const QString &html) {
-  QList<Listing> listings;
-
-  QRegularExpression rowRegex("<tr[^>]*class=\"([^\"]*)\"[^>]*>(.*?)</tr>",
-                              QRegularExpression::DotMatchesEverythingOption);
-  auto it = rowRegex.globalMatch(html);
-
-  while (it.hasNext()) {
-    auto match = it.next();
-    QString rowClass = match.captured(1);
-    QString rowContent = match.captured(2);
-
-    if (rowContent.contains("<th"))
-      continue;
-
-    Listing listing;
-    listing.isOwned = rowClass.contains("owned");
-
-    QRegularExpression tdRegex("<td[^>]*>(.*?)</td>",
-                               QRegularExpression::DotMatchesEverythingOption);
-    auto tdIt = tdRegex.globalMatch(rowContent);
-
-    QStringList cells;
-    while (tdIt.hasNext()) {
-      QString cell = tdIt.next().captured(1);
-      QRegularExpression inputRegex("<input[^>]*value=\"([^\"]*)\"");
-      auto inputMatch = inputRegex.match(cell);
-      if (inputMatch.hasMatch()) {
-        cell = inputMatch.captured(1);
-      }
-      cell.remove(QRegularExpression("<[^>]*>"));
-      cells.append(cell.trimmed());
-    }
-
-    if (cells.size() < 5)
-      continue;
-
-    listing.section = cells.value(1);
-    listing.venueArea = cells.value(2);
-    listing.quantity = cells.value(3).remove(QRegularExpression("\\D")).toInt();
-    listing.price = cleanPrice(cells.value(4));
-
-    if (listing.price > 0) {
-      listings.append(listing);
-    }
+const SectorResolver &CheckPrice::sectorResolver(const QString &pagePath) {
+  if (!m_sectorDbLoaded) {
+    m_sectorResolver.loadSectorDB();
+    m_sectorDbLoaded = true;
   }
-
-  return listings;
+  QFileInfo info(pagePath);
+  m_sectorResolver.setContext(SectorResolver::detectStadiumContext(
+      info.dir().dirName() + " " + info.completeBaseName()));
+  return m_sectorResolver;
 }
 
-QString CheckPrice::generateReport(Platform platform, CompareMode mode,
-                                   const QString &html1, const QString &html2) {
-  QList<Listing> owned;
-  QList<Listing> market;
-
-  if (platform == Platform::FTN) {
-    QList<Listing> all = parseFTNHtml(html1);
-    for (const auto &l : all) {
-      if (l.isOwned)
-        owned.append(l);
-      else
-        market.append(l);
-    }
-  } else if (platform == Platform::TIXSTOCK) {
-    owned = parseTixstockHtml(html1);
-    market = parseTixstockHtml(html2);
-  } else if (platform == Platform::VIAGOGO) {
-    QList<Listing> all = parseViagogoHtml(html1);
-    for (const auto &l : all) {
-      if (l.isOwned)
-        owned.append(l);
-      else
-        market.append(l);
-    }
-  }
+bool CheckPrice::recordHistory(const QList<PriceRecord> &records,
+                               const QMap<Platform, QString> &marketFiles) {
+  if (marketFiles.isEmpty())
+    return true;
 
-  if (owned.isEmpty()) {
-    return "No owned listings found. Please check the HTML file.";
+  // One history per event; the pages themselves do not say which
+  if (m_stock.name.isEmpty()) {
+    m_resultArea->append(
+        "\n⚠️ Price history not saved: load the event folder first.");
+    return false;
   }
-
-  QMap<QString, QList<Listing>> marketMap;
-  for (const auto &item : market) {
-    QString key;
-    if (platform == Platform::FTN) {
-      key = (mode == CompareMode::LEFT_FILTER)
-                ? QString("%1|%2")
-                      .arg(item.category.toLower())
-                      .arg(item.block.toLower())
-                : item.category.toLower();
-    } else if (platform == Platform::TIXSTOCK) {
-      key = (mode == CompareMode::LEFT_FILTER)
-                ? QString("%1|%2")
-                      .arg(item.category.toLower())
-                      .arg(item.section.toLower())
-                : item.category.toLower();
-    } else {
-      key = (mode == CompareMode::LEFT_FILTER) ? item.section.toLower()
-                                               : item.venueArea.toLower();
+  PriceHistoryStore store(PriceHistoryStore::pathForEvent(m_stock.name));
+
+  QMap<Platform, QList<PriceRecord>> byPlatform;
+  for (const PriceRecord &r : records)
+    byPlatform[r.platform].append(r);
+
+  for (auto it = marketFiles.constBegin(); it != marketFiles.constEnd(); ++it) {
+    QString error;
+    qint64 savedAt = QFileInfo(it.value()).lastModified().toMSecsSinceEpoch();
+    if (!store.append(savedAt, it.key(), byPlatform.value(it.key()), &error)) {
+      m_resultArea->append("\n⚠️ Price history not saved: " + error);
+      return false;
     }
-    marketMap[key].append(item);
   }
+  return true;
+}
 
-  QStringList reportLines;
-
-  for (const auto &item : owned) {
-    QString key;
-    if (platform == Platform::FTN) {
-      key = (mode == CompareMode::LEFT_FILTER)
-                ? QString("%1|%2")
-                      .arg(item.category.toLower())
-                      .arg(item.block.toLower())
-                : item.category.toLower();
-    } else if (platform == Platform::TIXSTOCK) {
-      key = (mode == CompareMode::LEFT_FILTER)
-                ? QString("%1|%2")
-                      .arg(item.category.toLower())
-                      .arg(item.section.toLower())
-                : item.category.toLower();
-    } else {
-      key = (mode == CompareMode::LEFT_FILTER) ? item.section.toLower()
-                                               : item.venueArea.toLower();
-    }
-
-    QList<Listing> comps = marketMap.value(key);
-
-    QList<double> validPrices;
-    for (const auto &comp : comps) {
-      if (comp.quantity == 1 && item.quantity > 1) {
-        continue;
-      }
-      validPrices.append(comp.price);
-    }
-
-    double bestComp =
-        validPrices.isEmpty()
-            ? 0.0
-            : *std::min_element(validPrices.begin(), validPrices.end());
+void CheckPrice::clearAll() {
+  m_resultArea->clear();
+  m_lastChecks.clear();
+}
 
-    QString status = "*FIRST*";
-    if (bestComp > 0 && item.price > bestComp + 0.01) {
-      status = "*NOT FIRST*";
-    }
+void CheckPrice::copyToClipboard() {
+  QString text = m_resultArea->toPlainText();
+  if (!text.isEmpty()) {
+    QApplication::clipboard()->setText(text);
+    QMessageBox::information(this, "Success", "Report copied to clipboard!");
+  }
+}
 
-    QString block;
-    if (platform == Platform::FTN) {
-      if (mode == CompareMode::LEFT_FILTER) {
-        block += QString("-%1 - block (Filter)\n")
-                     .arg(item.block.isEmpty() ? "No Block" : item.block);
-        block += QString("-%1 - category\n\n").arg(item.category);
-      } else {
-        block += QString("-%1 - category (Filter)\n").arg(item.category);
-        block += QString("-%1 - block\n\n")
-                     .arg(item.block.isEmpty() ? "No Block" : item.block);
-      }
-    } else if (platform == Platform::TIXSTOCK) {
-      if (mode == CompareMode::LEFT_FILTER) {
-        block += QString("-%1 - section (Filter)\n").arg(item.section);
-        block += QString("-%1 - category\n\n").arg(item.category);
-      } else {
-        block += QString("-%1 - category (Filter)\n").arg(item.category);
-        block += QString("-%1 - section\n\n").arg(item.section);
-      }
-    } else {
-      if (mode == CompareMode::LEFT_FILTER) {
-        block += QString("-%1 - section (Filter)\n").arg(item.section);
-        block += QString("-%1 - venue area\n\n").arg(item.venueArea);
-      } else {
-        block += QString("-%1 - venue area (Filter)\n").arg(item.venueArea);
-        block += QString("-%1 - section\n\n").arg(item.section);
-      }
-    }
+void CheckPrice::exportRepricing() {
+  if (m_lastChecks.isEmpty()) {
+    QMessageBox::warning(this, "Error",
+                         "Run LEFT or RIGHT FILTER first, then export.");
+    return;
+  }
 
-    block += QString("-Our Price=%.2f €\n").arg(item.price);
-    if (bestComp > 0) {
-      block += QString("-Comp Price=%.2f €\n").arg(bestComp);
-    } else {
-      block += "-Comp Price=NO COMPETITORS\n";
-    }
-    block += QString("%1\n").arg(status);
-    block += "---------------------------------";
+  QString fileName = QFileDialog::getSaveFileName(
+      this, "Export Repricing",
+      QString("Repricing_%1_%2.csv")
+          .arg(PriceEngine::platformName(m_lastPlatform),
+               QDateTime::currentDateTime().toString("yyyyMMdd_HHmm")),
+      "CSV Files (*.csv)");
+  if (fileName.isEmpty())
+    return;
 
-    reportLines.append(block);
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    QMessageBox::critical(this, "Error", "Could not write " + fileName);
+    return;
   }
-
-  return reportLines.join("\n");
+  QTextStream out(&file);
+  out.setEncoding(QStringConverter::Utf8);
+  out << PriceEngine::repricingCsv(m_lastPlatform, m_lastChecks);
+  QMessageBox::information(
+      this, "Success",
+      QString("%1 listings exported.").arg(m_lastChecks.size()));
 }
 
 } // namespace GOL
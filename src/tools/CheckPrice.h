@@ -3,39 +3,16 @@
 
 #include <QComboBox>
 #include <QDialog>
+#include <QFutureWatcher>
 #include <QLineEdit>
+#include <QMap>
 #include <QPushButton>
 #include <QTextEdit>
 
+#include "../core/PriceEngine.h"
 
 namespace GOL {
 
-// Platform types
-enum class Platform {
-  FTN,      // Football Ticket Net
-  TIXSTOCK, // Tixstock
-  VIAGOGO,  // Viagogo
-  UNKNOWN
-};
-
-// Comparison modes
-enum class CompareMode {
-  LEFT_FILTER, // Compare by Block/Section
-  RIGHT_FILTER // Compare by Category/Venue Area
-};
-
-// Listing data structure
-struct Listing {
-  bool isOwned;
-  QString category;
-  QString block;
-  QString section;
-  QString row;
-  QString venueArea;
-  double price;
-  int quantity;
-};
-
 class CheckPrice : public QDialog {
   Q_OBJECT
 
@@ -45,24 +22,32 @@ public:
 private slots:
   void browseFile1();
   void browseFile2();
+  void browseStock();
+  void onStockLoaded();
   void runLeftFilter();
   void runRightFilter();
+  void runAllPlatforms();
+  void onBatch();
+  void onBatchProgress(int value);
+  void onBatchResult(int index);
+  void onBatchFinished();
   void clearAll();
   void copyToClipboard();
+  void exportRepricing();
   void onPlatformChanged(int index);
 
 private:
-  QString generateReport(Platform platform, CompareMode mode,
-                         const QString &html1,
-                         const QString &html2 = QString());
-
-  // Platform-specific parsers
-  QList<Listing> parseFTNHtml(const QString &html);
-  QList<Listing> parseTixstockHtml(const QString &html);
-  QList<Listing> parseViagogoHtml(const QString &html);
-
-  // Helper functions
-  double cleanPrice(const QString &priceStr);
+  // Sector DB, loaded on first use, in the stadium context of a saved page
+  const SectorResolver &sectorResolver(const QString &pagePath);
+  // Face-value floors of the loaded event (none without one) and the
+  // resolver, both in the page's stadium context
+  PriceFloors priceFloors(const QString &pagePath);
+  // Runs the filter in m_currentMode on the selected files
+  void runFilter();
+  // Appends the parsed pages to the PriceHistoryStore of the loaded event;
+  // without one nothing is saved. False once the report says why not.
+  bool recordHistory(const QList<PriceRecord> &records,
+                     const QMap<Platform, QString> &marketFiles);
 
   // UI Elements
   QComboBox *m_platformSelector;
@@ -70,15 +55,28 @@ private:
   QLineEdit *m_file2Path;
   QPushButton *m_btnBrowse1;
   QPushButton *m_btnBrowse2;
+  QLineEdit *m_stockPath;
+  QPushButton *m_btnBrowseStock;
   QPushButton *m_btnLeftFilter;
   QPushButton *m_btnRightFilter;
+  QPushButton *m_btnAllPlatforms;
+  QPushButton *m_btnBatch;
   QPushButton *m_btnCopy;
+  QPushButton *m_btnExport;
   QPushButton *m_btnClear;
   QTextEdit *m_resultArea;
 
   // State
   Platform m_currentPlatform;
   CompareMode m_currentMode;
+  SectorResolver m_sectorResolver;
+  bool m_sectorDbLoaded = false;
+  StockModel::Event m_stock; // FV floors; empty until an event is loaded
+  QFutureWatcher<StockModel::Event> m_stockWatcher;
+  QFutureWatcher<PageCheck> m_batchWatcher;
+  QMap<int, PageCheck> m_batchPages; // Finished pages by folder position
+  QList<PriceCheck> m_lastChecks;
+  Platform m_lastPlatform = Platform::UNKNOWN;
 };
 
 } // namespace GOL
@@ -0,0 +1,169 @@
+#include "ListingTableModel.h"
+#include <QLineEdit>
+
+namespace GOL {
+
+ListingTableModel::ListingTableModel(QObject *parent)
+    : QAbstractTableModel(parent) {}
+
+int ListingTableModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+int ListingTableModel::columnCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : ColumnCount;
+}
+
+QString &ListingTableModel::cell(ListingRow &row, int column) {
+  switch (column) {
+  case GogoColumn:
+    return row.gogo;
+  case NetColumn:
+    return row.net;
+  case TixColumn:
+    return row.tix;
+  default:
+    return row.sector;
+  }
+}
+
+const QString &ListingTableModel::cell(const ListingRow &row, int column) {
+  return cell(const_cast<ListingRow &>(row), column);
+}
+
+QColor ListingTableModel::columnColor(int column) {
+  switch (column) {
+  case GogoColumn:
+    return QColor("#38bdf8");
+  case NetColumn:
+    return QColor("#fb7185");
+  case TixColumn:
+    return QColor("#fbbf24");
+  default:
+    return QColor("white");
+  }
+}
+
+QVariant ListingTableModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= m_rows.size())
+    return QVariant();
+
+  switch (role) {
+  case Qt::DisplayRole:
+  case Qt::EditRole:
+    return cell(m_rows[index.row()], index.column());
+  case Qt::ForegroundRole:
+    return columnColor(index.column());
+  case Qt::TextAlignmentRole:
+    return int(Qt::AlignCenter);
+  default:
+    return QVariant();
+  }
+}
+
+bool ListingTableModel::setData(const QModelIndex &index,
+                                const QVariant &value, int role) {
+  if (!index.isValid() || role != Qt::EditRole ||
+      index.row() >= m_rows.size())
+    return false;
+
+  QString &text = cell(m_rows[index.row()], index.column());
+  QString newText = value.toString();
+  if (text == newText)
+    return false;
+  text = newText;
+  emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+  return true;
+}
+
+Qt::ItemFlags ListingTableModel::flags(const QModelIndex &index) const {
+  if (!index.isValid())
+    return Qt::NoItemFlags;
+  return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+}
+
+QVariant ListingTableModel::headerData(int section,
+                                       Qt::Orientation orientation,
+                                       int role) const {
+  if (role != Qt::DisplayRole)
+    return QVariant();
+  if (orientation == Qt::Vertical)
+    return section + 1;
+
+  switch (section) {
+  case SectorColumn:
+    return "SECTOR";
+  case GogoColumn:
+    return "GOGO QTY";
+  case NetColumn:
+    return "NET QTY";
+  case TixColumn:
+    return "TIX QTY";
+  default:
+    return QVariant();
+  }
+}
+
+void ListingTableModel::appendRows(int count) {
+  if (count <= 0)
+    return;
+  int first = int(m_rows.size());
+  beginInsertRows(QModelIndex(), first, first + count - 1);
+  m_rows.resize(first + count);
+  endInsertRows();
+}
+
+void ListingTableModel::setSectors(const QStringList &sectors) {
+  beginResetModel();
+  if (m_rows.size() < sectors.size())
+    m_rows.resize(sectors.size());
+  for (int i = 0; i < m_rows.size(); ++i)
+    m_rows[i].sector = i < sectors.size() ? sectors[i] : QString();
+  endResetModel();
+}
+
+void ListingTableModel::clearCells() {
+  beginResetModel();
+  for (ListingRow &row : m_rows)
+    row = ListingRow();
+  endResetModel();
+}
+
+ListingEngine::ImportResult
+ListingTableModel::applyImports(const ListingEngine::Imports &imports,
+                                const QHash<QString, QString> &aliases) {
+  ListingEngine::ImportResult result =
+      ListingEngine::applyImports(m_rows, imports, aliases);
+  if (result.updatedRows > 0)
+    emit dataChanged(index(0, GogoColumn),
+                     index(int(m_rows.size()) - 1, TixColumn),
+                     {Qt::DisplayRole, Qt::EditRole});
+  return result;
+}
+
+QWidget *ListingCellDelegate::createEditor(QWidget *parent,
+                                           const QStyleOptionViewItem &,
+                                           const QModelIndex &index) const {
+  QLineEdit *e = new QLineEdit(parent);
+  e->setAlignment(Qt::AlignCenter);
+  e->setStyleSheet(QString("background-color: #0d0d0d; color: %1; border: "
+                           "none; border-radius: 4px;")
+                       .arg(ListingTableModel::columnColor(index.column())
+                                .name()));
+  return e;
+}
+
+void ListingCellDelegate::setEditorData(QWidget *editor,
+                                        const QModelIndex &index) const {
+  static_cast<QLineEdit *>(editor)->setText(
+      index.data(Qt::EditRole).toString());
+}
+
+void ListingCellDelegate::setModelData(QWidget *editor,
+                                       QAbstractItemModel *model,
+                                       const QModelIndex &index) const {
+  model->setData(index, static_cast<QLineEdit *>(editor)->text(),
+                 Qt::EditRole);
+}
+
+} // namespace GOL
@@ -0,0 +1,76 @@
+#ifndef LISTINGTABLEMODEL_H
+#define LISTINGTABLEMODEL_H
+
+#include "../core/ListingEngine.h"
+#include <QAbstractTableModel>
+#include <QColor>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QStyledItemDelegate>
+
+namespace GOL {
+
+// Unified listing table of CheckListing (sector + one quantity cell per
+// platform). Rows are plain ListingRow values: the view only draws what is
+// visible and bulk fills are a single model reset.
+class ListingTableModel : public QAbstractTableModel {
+  Q_OBJECT
+
+public:
+  enum Column { SectorColumn, GogoColumn, NetColumn, TixColumn, ColumnCount };
+
+  explicit ListingTableModel(QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  bool setData(const QModelIndex &index, const QVariant &value,
+               int role = Qt::EditRole) override;
+  Qt::ItemFlags flags(const QModelIndex &index) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+
+  const QList<ListingRow> &listingRows() const { return m_rows; }
+
+  void appendRows(int count);
+  // Sector column from a stock report, growing the table as needed; other
+  // sector cells are cleared, quantities are kept
+  void setSectors(const QStringList &sectors);
+  // Empties every cell, keeping the row count
+  void clearCells();
+  // Importer results into the platform columns (ListingEngine::applyImports)
+  ListingEngine::ImportResult
+  applyImports(const ListingEngine::Imports &imports,
+               const QHash<QString, QString> &aliases);
+
+  static QColor columnColor(int column);
+
+private:
+  static QString &cell(ListingRow &row, int column);
+  static const QString &cell(const ListingRow &row, int column);
+
+  QList<ListingRow> m_rows;
+};
+
+// Editor for the listing cells: the dark, centred, column-coloured line
+// edit the table used before it became a view
+class ListingCellDelegate : public QStyledItemDelegate {
+  Q_OBJECT
+
+public:
+  using QStyledItemDelegate::QStyledItemDelegate;
+
+  QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                        const QModelIndex &index) const override;
+  void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+  void setModelData(QWidget *editor, QAbstractItemModel *model,
+                    const QModelIndex &index) const override;
+};
+
+} // namespace GOL
+
+#endif // LISTINGTABLEMODEL_H
@@ -1,6 +1,7 @@
 #ifndef STOCKREPORT_H
 #define STOCKREPORT_H
 
+#include <QCheckBox>
 #include <QDialog>
 #include <QDir>
 #include <QLineEdit>
@@ -9,11 +10,14 @@
 #include <QPushButton>
 #include <QSet>
 #include <QTextEdit>
-#include <tuple>
 
+#include "../core/EventSnapshot.h"
+#include "../core/SectorResolver.h"
 
 namespace GOL {
 
+class FolderWatcher;
+
 class StockReport : public QDialog {
   Q_OBJECT
 
@@ -23,47 +27,19 @@ public:
 private slots:
   void browseFolder();
   void startAnalysis();
+  void toggleLiveMode(bool on);
+  void onFoldersChanged(const QStringList &folders);
 
 private:
   void log(const QString &msg);
+  // Returns false if the folder is invalid. Live runs analyze the snapshot
+  // onFoldersChanged updated and keep report.txt untouched when nothing
+  // changed.
+  bool runAnalysis(bool live);
 
-  // Core Logic
-  struct StockInfo {
-    int count = 0;
-    QSet<QString> files;
-  };
-
-  struct OrderInfo {
-    QString folderName;
-    QString sectorName;     // Raw from folder
-    QString resolvedSector; // After mapping
-    QString platform;       // Gogo, Net, Tixstock, etc.
-    QString orderStatus;    // "Bought with names", "Bought need info", etc.
-    int quantity = 0;
-    bool isPending = false;
-    bool isBought = false;       // "BOUGHT" is present
-    bool isStockRequest = false; // Pending but NOT Bought (Needs Stock)
-  };
-
-  // Helper to find "caricati" variations
-  QString findDeliveredFolder(const QDir &rootDir);
-
-  // New Logic Helpers
-  QString classifyPlatform(const QString &folderName);
-  QPair<QString, int> parseSectorAndQuantity(const QString &folderName,
-                                             const QString &fullPath = "");
-  int countPdfs(const QString &path);
-
-  // Mapping & Context
+  // Mapping
   void loadMappings();
   void saveMappings();
-  void loadSectorDB(); // New JSON DB
-  QString detectStadiumContext(const QString &folderName);
-  QString getCanonicalSectorName(const QString &raw); // Added Declaration
-
-  // Logic from CalcStock
-  std::tuple<QString, QString, QString>
-  extractSrsFromFilename(const QString &filename);
 
   QString resolveSector(const QString &folderSectorName,
                         const QStringList &availableSectors,
@@ -83,15 +59,21 @@ private:
 
   QMap<QString, QString> m_sectorMap; // FolderName -> RealSectorName
 
-  // Sector DB: Context -> (Sector -> [Blocks])
-  QMap<QString, QMap<QString, QStringList>> m_sectorDB;
-  QString m_currentContext;
+  // Sector DB + stadium context; loaded once so live reruns keep the
+  // compiled rules and the canonical name cache
+  SectorResolver m_resolver;
+  bool m_sectorDbLoaded = false;
 
   // UI
   QLineEdit *m_pathEdit;
   QPushButton *m_btnBrowse;
   QPushButton *m_btnRun;
+  QCheckBox *m_liveMode;
   QTextEdit *m_reportArea;
+
+  FolderWatcher *m_watcher;
+  EventSnapshot m_snapshot; // Event tree the last report was built from
+  QString m_lastReport;
 };
 
 } // namespace GOL
@@ -23,11 +23,6 @@ private slots:
 
 private:
   void log(const QString &msg);
-  QString cleanHeader(const QString &h);
-  QStringList extractFromCsv(const QString &path);
-  QStringList extractFromExcel(const QString &path);
-  // Note: Excel extraction requires extra libs, for now we support CSV
-  // prominently
 
   QLineEdit *m_pathEdit;
   QStringList m_salesFiles;
@@ -35,9 +30,6 @@ private:
   QPushButton *m_btnSales;
   QPushButton *m_btnRun;
   QTextEdit *m_logArea;
-
-  const QStringList ALLOWED_COLUMNS = {"id", "transactionid", "order id",
-                                       "orderid"};
 };
 
 } // namespace GOL